@@ -0,0 +1,266 @@
+#include "Arena.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ Сайты: https://en.cppreference.com/w/cpp/memory/memory_resource
+        https://habr.com/ru/articles/505632/
+ */
+
+namespace arena
+{
+    namespace
+    {
+        /// Нетривиальный деструктор: без register_finalizer Arena::make не скомпилируется
+        struct Session
+        {
+            std::string name;
+            int* counter;
+            
+            Session(std::string name, int* counter) : name(std::move(name)), counter(counter) {}
+            ~Session() { ++*counter; }
+        };
+    }
+    
+    template <>
+    struct register_finalizer<Session> : std::true_type {};
+    
+    Arena::Arena(size_t block_size, std::pmr::memory_resource* upstream) : _upstream(upstream), _block_size(block_size)
+    {
+    }
+    
+    Arena::~Arena()
+    {
+        release();
+    }
+    
+    void* Arena::allocate_slow(size_t bytes, size_t alignment)
+    {
+        const size_t needed = bytes + alignment; // с запасом на выравнивание
+        Block* next = _current != nullptr ? _current->next : _first;
+        
+        // После reset()/rewind() следующие блоки уже есть - переиспользуем, если помещаемся
+        if (next == nullptr || next->size < needed)
+        {
+            const size_t size = std::max(_block_size, needed);
+            auto* block = static_cast<Block*>(_upstream->allocate(sizeof(Block) + size, alignof(std::max_align_t)));
+            block->next = next;
+            block->size = size;
+            if (_current != nullptr)
+                _current->next = block;
+            else
+                _first = block;
+            next = block;
+            _capacity += size;
+            ++_blocks;
+        }
+        
+        _current = next;
+        _cursor = next->begin();
+        _end = next->end();
+        return bump(bytes, alignment);
+    }
+    
+    void Arena::run_finalizers(Finalizer* until) noexcept
+    {
+        while (_finalizers != until)
+        {
+            Finalizer* finalizer = _finalizers;
+            _finalizers = finalizer->next;
+            finalizer->destroy(finalizer->object);
+        }
+    }
+    
+    void Arena::rewind(const Marker& marker) noexcept
+    {
+        run_finalizers(marker.finalizers);
+        if (marker.block == nullptr)
+        {
+            _current = _first;
+            _cursor = _first != nullptr ? _first->begin() : nullptr;
+            _end = _first != nullptr ? _first->end() : nullptr;
+        }
+        else
+        {
+            _current = marker.block;
+            _cursor = marker.cursor;
+            _end = marker.block->end();
+        }
+    }
+    
+    void Arena::release() noexcept
+    {
+        run_finalizers(nullptr);
+        while (_first != nullptr)
+        {
+            Block* block = _first;
+            _first = block->next;
+            _upstream->deallocate(block, sizeof(Block) + block->size, alignof(std::max_align_t));
+        }
+        _current = nullptr;
+        _cursor = _end = nullptr;
+        _capacity = _blocks = 0;
+    }
+    
+    size_t Arena::used() const noexcept
+    {
+        size_t bytes = 0;
+        for (Block* block = _first; block != nullptr && block != _current; block = block->next)
+            bytes += block->size;
+        if (_current != nullptr)
+            bytes += static_cast<size_t>(_cursor - _current->begin());
+        return bytes;
+    }
+    
+    void Start()
+    {
+        std::cout << "arena" << std::endl;
+        
+        // Тривиальный тип (см. POD.cpp: trivial_type): деструктор ничего не делает
+        struct Order
+        {
+            std::int64_t id;
+            double price;
+            std::int32_t quantity;
+            std::int32_t flags;
+            Order* next;
+            char symbol[16];
+        };
+        
+        /// Вложенные области и финализаторы
+        {
+            Arena arena(4096);
+            int destroyed = 0;
+            
+            arena.make<Order>();
+            {
+                Arena::Scope scope(arena);
+                arena.make_array<Order>(100);
+                arena.make<Session>("request", &destroyed);
+                std::cout << "used внутри Scope: " << arena.used() << std::endl;
+            }
+            std::cout << "used после Scope: " << arena.used() << ", вызвано деструкторов: " << destroyed << std::endl;
+            
+            // arena.make<std::string>("text"); // Ошибка: static_assert - нетривиальный деструктор без register_finalizer
+            
+            std::pmr::vector<int> numbers(&arena); // Arena - это std::pmr::memory_resource
+            for (int i = 0; i < 1000; ++i)
+                numbers.push_back(i);
+            std::cout << "pmr::vector в арене, блоков: " << arena.blocks() << std::endl;
+        }
+        
+        /*
+         Шаблон запроса: создать много мелких объектов, поработать с ними и выбросить все разом.
+         malloc/free и new/delete платят за каждый объект дважды, Arena - один сдвиг указателя и один reset на весь запрос.
+         */
+        {
+            constexpr size_t requests = 2000;
+            constexpr size_t objects = 1000;
+            std::vector<Order*> orders(objects);
+            
+            const double malloc_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    for (auto& order : orders)
+                    {
+                        order = ::new (std::malloc(sizeof(Order))) Order{};
+                        order->id = static_cast<std::int64_t>(request);
+                    }
+                    benchmark::do_not_optimize(orders.back()->id);
+                    for (auto* order : orders)
+                        std::free(order);
+                }
+            }, 3);
+            
+            const double new_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    for (auto& order : orders)
+                    {
+                        order = new Order{};
+                        order->id = static_cast<std::int64_t>(request);
+                    }
+                    benchmark::do_not_optimize(orders.back()->id);
+                    for (auto* order : orders)
+                        delete order;
+                }
+            }, 3);
+            
+            Arena arena;
+            const double arena_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    for (auto& order : orders)
+                    {
+                        order = arena.make<Order>();
+                        order->id = static_cast<std::int64_t>(request);
+                    }
+                    benchmark::do_not_optimize(orders.back()->id);
+                    arena.reset();
+                }
+            }, 3);
+            
+            std::pmr::monotonic_buffer_resource monotonic;
+            const double monotonic_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    for (auto& order : orders)
+                    {
+                        order = ::new (monotonic.allocate(sizeof(Order), alignof(Order))) Order{};
+                        order->id = static_cast<std::int64_t>(request);
+                    }
+                    benchmark::do_not_optimize(orders.back()->id);
+                    monotonic.release(); // в отличие от reset() возвращает блоки upstream ресурсу
+                }
+            }, 3);
+            
+            const double operations = static_cast<double>(requests * objects);
+            std::cout << "Запросы: " << requests << " x " << objects << " объектов по " << sizeof(Order) << " байт" << std::endl;
+            std::cout << std::setw(28) << "malloc/free: " << malloc_ms << " ms, " << malloc_ms * 1e6 / operations << " ns/объект" << std::endl;
+            std::cout << std::setw(28) << "new/delete: " << new_ms << " ms, " << new_ms * 1e6 / operations << " ns/объект" << std::endl;
+            std::cout << std::setw(28) << "Arena + reset: " << arena_ms << " ms, " << arena_ms * 1e6 / operations << " ns/объект" << std::endl;
+            std::cout << std::setw(28) << "monotonic_buffer_resource: " << monotonic_ms << " ms, " << monotonic_ms * 1e6 / operations << " ns/объект" << std::endl;
+            
+            // Контейнеры запроса: std::vector против std::pmr::vector в арене
+            const double vector_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    std::vector<std::int64_t> values;
+                    for (size_t i = 0; i < objects; ++i)
+                        values.push_back(static_cast<std::int64_t>(i));
+                    benchmark::do_not_optimize(values.back());
+                }
+            }, 3);
+            
+            const double pmr_vector_ms = benchmark::measure_ms([&]
+            {
+                for (size_t request = 0; request < requests; ++request)
+                {
+                    {
+                        std::pmr::vector<std::int64_t> values(&arena);
+                        for (size_t i = 0; i < objects; ++i)
+                            values.push_back(static_cast<std::int64_t>(i));
+                        benchmark::do_not_optimize(values.back());
+                    }
+                    arena.reset();
+                }
+            }, 3);
+            
+            std::cout << std::setw(28) << "std::vector: " << vector_ms << " ms" << std::endl;
+            std::cout << std::setw(28) << "std::pmr::vector + Arena: " << pmr_vector_ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,151 @@
+#ifndef Arena_hpp
+#define Arena_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ Arena (регион, monotonic resource) - память выделяется сдвигом указателя (bump allocation) внутри больших блоков, а освобождается сразу вся: reset() за O(1) возвращает указатель в начало, блоки остаются для следующего запроса.
+ Для тривиально разрушаемых типов (trivial type из POD.cpp) поштучный delete - это чистые накладные расходы: деструктор пустой, а free нужен только аллокатору.
+ Типы с нетривиальным деструктором запрещены на этапе компиляции, пока для них явно не зарегистрирован финализатор (register_finalizer) - тогда деструкторы вызываются при reset()/выходе из Scope в обратном порядке.
+ Arena наследуется от std::pmr::memory_resource, поэтому подходит для любых std::pmr контейнеров.
+ */
+namespace arena
+{
+    /// Специализация с std::true_type разрешает класть в Arena тип с нетривиальным деструктором
+    template <class T>
+    struct register_finalizer : std::false_type {};
+    
+    /// Блок памяти арены: заголовок + данные
+    struct Block
+    {
+        Block* next;
+        size_t size; // размер данных после заголовка
+        
+        char* begin() noexcept { return reinterpret_cast<char*>(this + 1); }
+        char* end() noexcept { return begin() + size; }
+    };
+    
+    /// Зарегистрированный деструктор объекта в арене
+    struct Finalizer
+    {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+    
+    class Arena final : public std::pmr::memory_resource
+    {
+    public:
+        /// Положение в арене, к которому можно откатиться
+        struct Marker
+        {
+            Block* block = nullptr;
+            char* cursor = nullptr;
+            Finalizer* finalizers = nullptr;
+        };
+        
+        /// Вложенная область: при выходе память и объекты, созданные внутри, освобождаются
+        class Scope
+        {
+        public:
+            explicit Scope(Arena& arena) : _arena(arena), _marker(arena.marker()) {}
+            ~Scope() { _arena.rewind(_marker); }
+            
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        
+        private:
+            Arena& _arena;
+            Marker _marker;
+        };
+        
+        explicit Arena(size_t block_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~Arena() override;
+        
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        
+        template <class T, class... Args>
+        T* make(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T> || register_finalizer<T>::value,
+                          "Arena не вызывает деструкторы: тип должен быть trivially destructible или иметь register_finalizer");
+            
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                return ::new (bump(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            else
+            {
+                // Узел финализатора выделяется раньше объекта, чтобы при откате объект разрушался до освобождения своей памяти
+                auto* finalizer = static_cast<Finalizer*>(bump(sizeof(Finalizer), alignof(Finalizer)));
+                T* object = ::new (bump(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                *finalizer = Finalizer{[](void* pointer) { static_cast<T*>(pointer)->~T(); }, object, _finalizers};
+                _finalizers = finalizer;
+                return object;
+            }
+        }
+        
+        template <class T>
+        T* make_array(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "make_array только для trivially destructible типов");
+            T* objects = static_cast<T*>(bump(sizeof(T) * count, alignof(T)));
+            for (size_t i = 0; i < count; ++i)
+                ::new (objects + i) T();
+            return objects;
+        }
+        
+        Marker marker() const noexcept { return {_current, _cursor, _finalizers}; }
+        /// Откат к положению marker: вызываются финализаторы, созданные позже, память переиспользуется
+        void rewind(const Marker& marker) noexcept;
+        /// Освобождает все объекты за O(1) (не считая зарегистрированных финализаторов), блоки остаются в арене
+        void reset() noexcept { rewind({}); }
+        /// Возвращает все блоки upstream ресурсу
+        void release() noexcept;
+        
+        size_t used() const noexcept;
+        size_t capacity() const noexcept { return _capacity; }
+        size_t blocks() const noexcept { return _blocks; }
+    
+    private:
+        /// Быстрый путь: выравнивание и сдвиг указателя внутри текущего блока
+        void* bump(size_t bytes, size_t alignment)
+        {
+            const auto cursor = reinterpret_cast<std::uintptr_t>(_cursor);
+            const auto aligned = (cursor + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            if (_cursor != nullptr && aligned + bytes <= reinterpret_cast<std::uintptr_t>(_end))
+            {
+                _cursor = reinterpret_cast<char*>(aligned + bytes);
+                return reinterpret_cast<void*>(aligned);
+            }
+            return allocate_slow(bytes, alignment);
+        }
+        
+        void* do_allocate(size_t bytes, size_t alignment) override { return bump(bytes, alignment); }
+        void do_deallocate(void*, size_t, size_t) override {} // память освобождается только целиком
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        
+        void* allocate_slow(size_t bytes, size_t alignment);
+        void run_finalizers(Finalizer* until) noexcept;
+        
+        std::pmr::memory_resource* _upstream;
+        size_t _block_size;
+        Block* _first = nullptr;
+        Block* _current = nullptr;
+        char* _cursor = nullptr;
+        char* _end = nullptr;
+        Finalizer* _finalizers = nullptr;
+        size_t _capacity = 0;
+        size_t _blocks = 0;
+    };
+    
+    void Start();
+}
+
+#endif /* Arena_hpp */
@@ -0,0 +1,638 @@
+#include "Async_Writer.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define ASYNC_WRITER_IO_URING
+#endif
+
+/*
+ Сайты: https://kernel.dk/io_uring.pdf
+        https://habr.com/ru/companies/ruvds/articles/781338/
+        https://man7.org/linux/man-pages/man2/pwrite.2.html
+ */
+
+namespace async_writer
+{
+    namespace
+    {
+        constexpr size_t buffer_alignment = 4096; // граница страницы: ядру не нужно копировать невыровненные хвосты
+    }
+    
+    struct AsyncWriter::Buffer
+    {
+        explicit Buffer(size_t capacity)
+            : data(static_cast<char*>(::operator new(capacity, std::align_val_t{buffer_alignment}))), capacity(capacity)
+        {
+        }
+        
+        ~Buffer()
+        {
+            ::operator delete(data, std::align_val_t{buffer_alignment});
+        }
+        
+        char* data;
+        size_t capacity;
+        size_t size = 0;
+        std::uint64_t offset = 0;  // смещение в файле, назначается при отправке
+        size_t written = 0;        // для коротких записей io_uring
+#if defined(ASYNC_WRITER_IO_URING)
+        iovec iov{};
+#endif
+    };
+    
+    /// Файл с позиционной записью
+    class AsyncWriter::File
+    {
+    public:
+        explicit File(const std::filesystem::path& path)
+        {
+#if defined(_WIN32)
+            _handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (_handle == INVALID_HANDLE_VALUE)
+                throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "CreateFile");
+#else
+            _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (_fd < 0)
+                throw std::system_error(errno, std::generic_category(), "open");
+#endif
+        }
+        
+        ~File()
+        {
+#if defined(_WIN32)
+            CloseHandle(_handle);
+#else
+            ::close(_fd);
+#endif
+        }
+        
+        /// 0 - успех, иначе код ошибки
+        int write_at(const char* data, size_t size, std::uint64_t offset) noexcept
+        {
+            while (size > 0)
+            {
+#if defined(_WIN32)
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD written = 0;
+                const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                if (!WriteFile(_handle, data, chunk, &written, &overlapped))
+                    return static_cast<int>(GetLastError());
+#else
+                const ssize_t written = ::pwrite(_fd, data, size, static_cast<off_t>(offset));
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return errno;
+                }
+#endif
+                if (written == 0)
+                    return EIO; // устройство ничего не приняло - повтор зациклился бы
+                data += written;
+                size -= static_cast<size_t>(written);
+                offset += static_cast<std::uint64_t>(written);
+            }
+            return 0;
+        }
+        
+        int sync() noexcept
+        {
+#if defined(_WIN32)
+            return FlushFileBuffers(_handle) ? 0 : static_cast<int>(GetLastError());
+#else
+            return ::fsync(_fd) == 0 ? 0 : errno;
+#endif
+        }
+
+#if !defined(_WIN32)
+        int descriptor() const noexcept { return _fd; }
+#endif
+    
+    private:
+#if defined(_WIN32)
+        HANDLE _handle;
+#else
+        int _fd;
+#endif
+    };
+    
+    class AsyncWriter::Backend
+    {
+    public:
+        virtual ~Backend() = default;
+        virtual void submit(Buffer& buffer) = 0;
+        virtual const char* name() const noexcept = 0;
+    };
+    
+    /// Запасной вариант: очередь буферов и потоки, каждый пишет свой буфер через pwrite
+    class AsyncWriter::ThreadPoolBackend final : public Backend
+    {
+    public:
+        ThreadPoolBackend(AsyncWriter& writer, size_t threads) : _writer(writer)
+        {
+            for (size_t i = 0; i < std::max<size_t>(1, threads); ++i)
+                _threads.emplace_back([this] { run(); });
+        }
+        
+        ~ThreadPoolBackend() override
+        {
+            {
+                std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (auto& thread : _threads)
+                thread.join();
+        }
+        
+        void submit(Buffer& buffer) override
+        {
+            {
+                std::lock_guard lock(_mutex);
+                _queue.push_back(&buffer);
+            }
+            _condition.notify_one();
+        }
+        
+        const char* name() const noexcept override { return "thread pool + pwrite"; }
+    
+    private:
+        void run()
+        {
+            for (;;)
+            {
+                Buffer* buffer = nullptr;
+                {
+                    std::unique_lock lock(_mutex);
+                    _condition.wait(lock, [this] { return _stop || !_queue.empty(); });
+                    if (_queue.empty())
+                        return;
+                    buffer = _queue.front();
+                    _queue.pop_front();
+                }
+                const int error = _writer._file->write_at(buffer->data, buffer->size, buffer->offset);
+                _writer.complete(*buffer, error);
+            }
+        }
+        
+        AsyncWriter& _writer;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::deque<Buffer*> _queue;
+        bool _stop = false;
+        std::vector<std::thread> _threads;
+    };
+
+#if defined(ASYNC_WRITER_IO_URING)
+    /*
+     io_uring без liburing: кольца отправки (SQ) и завершения (CQ) отображаются в память процесса через mmap.
+     Отправка - запись SQE в кольцо и io_uring_enter, завершения собирает отдельный поток, ожидая в io_uring_enter(GETEVENTS).
+     */
+    class AsyncWriter::IoUringBackend final : public Backend
+    {
+    public:
+        static std::unique_ptr<Backend> create(AsyncWriter& writer, unsigned entries)
+        {
+            auto backend = std::unique_ptr<IoUringBackend>(new IoUringBackend(writer));
+            if (!backend->setup(entries))
+                return nullptr; // ядро без io_uring или системный вызов запрещен (seccomp)
+            backend->_reaper = std::thread([raw = backend.get()] { raw->reap(); });
+            return backend;
+        }
+        
+        ~IoUringBackend() override
+        {
+            if (_reaper.joinable())
+            {
+                // user_data = 0 - сигнал остановки для потока завершений; временная ошибка отправки (EAGAIN, EBUSY) повторяется, пока поток завершений жив
+                while (push(IORING_OP_NOP, nullptr) != 0 && !failed())
+                    std::this_thread::yield();
+                _reaper.join();
+            }
+            if (_sqes != nullptr)
+                munmap(_sqes, _sqes_size);
+            if (_cq_ring != nullptr && _cq_ring != _sq_ring)
+                munmap(_cq_ring, _cq_ring_size);
+            if (_sq_ring != nullptr)
+                munmap(_sq_ring, _sq_ring_size);
+            if (_ring_fd >= 0)
+                ::close(_ring_fd);
+        }
+        
+        void submit(Buffer& buffer) override
+        {
+            buffer.written = 0;
+            if (const int error = push(IORING_OP_WRITEV, &buffer))
+                _writer.complete(buffer, error);
+        }
+        
+        const char* name() const noexcept override { return "io_uring"; }
+    
+    private:
+        explicit IoUringBackend(AsyncWriter& writer) : _writer(writer) {}
+        
+        static int enter(int fd, unsigned submit, unsigned wait, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0));
+        }
+        
+        bool setup(unsigned entries)
+        {
+            io_uring_params params{};
+            _ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (_ring_fd < 0)
+                return false;
+            
+            _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+                _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+            
+            _sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+            if (_sq_ring == MAP_FAILED)
+            {
+                _sq_ring = nullptr;
+                return false;
+            }
+            _cq_ring = single_mmap ? _sq_ring : mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+            if (_cq_ring == MAP_FAILED)
+            {
+                _cq_ring = nullptr;
+                return false;
+            }
+            _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            _sqes = static_cast<io_uring_sqe*>(mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES));
+            if (_sqes == MAP_FAILED)
+            {
+                _sqes = nullptr;
+                return false;
+            }
+            
+            auto* sq = static_cast<char*>(_sq_ring);
+            _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            
+            auto* cq = static_cast<char*>(_cq_ring);
+            _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+        
+        /// Отправляет одну операцию: 0 или код ошибки. Буферов в полете не больше max_in_flight < размера кольца, поэтому место в SQ есть всегда
+        int push(std::uint8_t opcode, Buffer* buffer)
+        {
+            std::lock_guard lock(_submit_mutex);
+            if (_failed != 0)
+                return _failed; // поток завершений остановлен: отправленное никто не соберет
+            const unsigned tail = *_sq_tail;
+            const unsigned index = tail & _sq_mask;
+            io_uring_sqe& sqe = _sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = opcode;
+            sqe.fd = -1;
+            if (buffer != nullptr)
+            {
+                buffer->iov.iov_base = buffer->data + buffer->written;
+                buffer->iov.iov_len = buffer->size - buffer->written;
+                sqe.fd = _writer._file->descriptor();
+                sqe.addr = reinterpret_cast<std::uint64_t>(&buffer->iov);
+                sqe.len = 1;
+                sqe.off = buffer->offset + buffer->written;
+            }
+            sqe.user_data = reinterpret_cast<std::uint64_t>(buffer);
+            _sq_array[index] = index;
+            __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            
+            for (;;)
+            {
+                if (enter(_ring_fd, 1, 0, 0) >= 0)
+                {
+                    if (buffer != nullptr && std::find(_pending.begin(), _pending.end(), buffer) == _pending.end())
+                        _pending.push_back(buffer);
+                    return 0;
+                }
+                if (errno != EINTR)
+                    break;
+            }
+            // При ошибке io_uring_enter ядро не забрало ни одного SQE: он убирается из кольца, иначе его отправил бы следующий вызов
+            const int error = errno;
+            __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+            return error;
+        }
+        
+        bool failed()
+        {
+            std::lock_guard lock(_submit_mutex);
+            return _failed != 0;
+        }
+        
+        void finish(Buffer& buffer, int error)
+        {
+            {
+                std::lock_guard lock(_submit_mutex);
+                _pending.erase(std::remove(_pending.begin(), _pending.end(), &buffer), _pending.end());
+            }
+            _writer.complete(buffer, error);
+        }
+        
+        /// Ожидание завершений невозможно: все отправленные буферы завершаются с ошибкой, иначе flush() ждал бы их вечно
+        void fail(int error)
+        {
+            std::vector<Buffer*> pending;
+            {
+                std::lock_guard lock(_submit_mutex);
+                _failed = error;
+                pending.swap(_pending);
+            }
+            for (Buffer* buffer : pending)
+                _writer.complete(*buffer, error);
+        }
+        
+        void reap()
+        {
+            for (;;)
+            {
+                if (enter(_ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    fail(errno);
+                    return;
+                }
+                
+                unsigned head = *_cq_head;
+                const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+                bool stop = false;
+                for (; head != tail; ++head)
+                {
+                    const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+                    auto* buffer = reinterpret_cast<Buffer*>(cqe.user_data);
+                    const int result = cqe.res;
+                    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+                    
+                    if (buffer == nullptr)
+                        stop = true;
+                    else if (result < 0)
+                        finish(*buffer, -result);
+                    else if (buffer->written + static_cast<size_t>(result) < buffer->size && result > 0)
+                    {
+                        buffer->written += static_cast<size_t>(result); // короткая запись: дописываем остаток
+                        if (const int error = push(IORING_OP_WRITEV, buffer))
+                            finish(*buffer, error);
+                    }
+                    else
+                        finish(*buffer, result == 0 ? EIO : 0);
+                }
+                if (stop)
+                    return;
+            }
+        }
+        
+        AsyncWriter& _writer;
+        int _ring_fd = -1;
+        void* _sq_ring = nullptr;
+        void* _cq_ring = nullptr;
+        size_t _sq_ring_size = 0;
+        size_t _cq_ring_size = 0;
+        io_uring_sqe* _sqes = nullptr;
+        size_t _sqes_size = 0;
+        unsigned* _sq_tail = nullptr;
+        unsigned* _sq_array = nullptr;
+        unsigned _sq_mask = 0;
+        unsigned* _cq_head = nullptr;
+        unsigned* _cq_tail = nullptr;
+        unsigned _cq_mask = 0;
+        io_uring_cqe* _cqes = nullptr;
+        std::mutex _submit_mutex;
+        std::vector<Buffer*> _pending; // отправлены в ядро и еще не завершены
+        int _failed = 0;               // ошибка io_uring_enter в потоке завершений
+        std::thread _reaper;
+    };
+#endif
+    
+    AsyncWriter::AsyncWriter(const std::filesystem::path& path) : AsyncWriter(path, Options{})
+    {
+    }
+    
+    AsyncWriter::AsyncWriter(const std::filesystem::path& path, const Options& options)
+        : _options(options), _file(std::make_unique<File>(path))
+    {
+        _options.buffer_size = std::max(buffer_alignment, (_options.buffer_size + buffer_alignment - 1) / buffer_alignment * buffer_alignment);
+        _options.max_in_flight = std::max<size_t>(1, _options.max_in_flight);
+        for (size_t i = 0; i < _options.max_in_flight; ++i)
+        {
+            _buffers.push_back(std::make_unique<Buffer>(_options.buffer_size));
+            _free.push_back(_buffers.back().get());
+        }
+
+#if defined(ASYNC_WRITER_IO_URING)
+        if (_options.use_io_uring)
+            _backend = IoUringBackend::create(*this, static_cast<unsigned>(std::bit_ceil(_options.max_in_flight + 1)));
+#endif
+        if (_backend == nullptr)
+            _backend = std::make_unique<ThreadPoolBackend>(*this, _options.threads);
+    }
+    
+    AsyncWriter::~AsyncWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // Ошибку записи из деструктора сообщить некуда: кто хочет ее знать - вызывает flush() явно
+        }
+        _backend.reset(); // потоки записи останавливаются до освобождения буферов и файла
+    }
+    
+    AsyncWriter::Buffer* AsyncWriter::acquire()
+    {
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return !_free.empty(); }); // back-pressure: ждем, пока запишется хотя бы один буфер
+        Buffer* buffer = _free.back();
+        _free.pop_back();
+        buffer->size = 0;
+        return buffer;
+    }
+    
+    void AsyncWriter::submit_current()
+    {
+        if (_current == nullptr)
+            return;
+        if (_current->size == 0)
+        {
+            std::lock_guard lock(_mutex);
+            _free.push_back(_current);
+            _current = nullptr;
+            return;
+        }
+        
+        _current->offset = _offset;
+        _offset += _current->size;
+        {
+            std::lock_guard lock(_mutex);
+            ++_in_flight;
+        }
+        Buffer* buffer = std::exchange(_current, nullptr);
+        _backend->submit(*buffer);
+    }
+    
+    void AsyncWriter::complete(Buffer& buffer, int error)
+    {
+        {
+            std::lock_guard lock(_mutex);
+            if (error != 0 && _error == 0)
+                _error = error;
+            _free.push_back(&buffer);
+            --_in_flight;
+        }
+        _condition.notify_all();
+    }
+    
+    void AsyncWriter::write_bytes(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            if (_current == nullptr)
+                _current = acquire();
+            
+            const size_t chunk = std::min(size, _current->capacity - _current->size);
+            std::memcpy(_current->data + _current->size, bytes, chunk);
+            _current->size += chunk;
+            bytes += chunk;
+            size -= chunk;
+            
+            if (_current->size == _current->capacity)
+                submit_current();
+        }
+    }
+    
+    void AsyncWriter::flush()
+    {
+        submit_current();
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return _in_flight == 0; });
+        if (_error != 0)
+            throw std::system_error(std::exchange(_error, 0), std::generic_category(), "AsyncWriter");
+    }
+    
+    void AsyncWriter::sync()
+    {
+        flush();
+        if (const int error = _file->sync(); error != 0)
+            throw std::system_error(error, std::generic_category(), "fsync");
+    }
+    
+    const char* AsyncWriter::backend() const noexcept
+    {
+        return _backend->name();
+    }
+    
+    void Start()
+    {
+        std::cout << "async writer" << std::endl;
+        
+        struct Record // POD: 64 байта
+        {
+            std::uint64_t id;
+            std::uint64_t timestamp;
+            double values[6];
+        };
+        
+        constexpr size_t batch = 512;             // записей в пачке (32 KiB)
+        constexpr size_t batches = 4096;          // 128 MiB всего
+        constexpr double megabytes = batch * batches * sizeof(Record) / (1024.0 * 1024.0);
+        const auto directory = std::filesystem::temp_directory_path();
+        std::vector<Record> records(batch);
+        
+        // Производитель: готовит очередную пачку записей
+        auto produce = [&records](size_t number)
+        {
+            for (size_t i = 0; i < records.size(); ++i)
+                records[i] = Record{number * records.size() + i, number, {1, 2, 3, 4, 5, 6}};
+            return std::span<const Record>(records);
+        };
+        
+        auto report = [megabytes](const char* name, double ms)
+        {
+            std::cout << std::setw(32) << name << std::setw(10) << std::fixed << std::setprecision(0) << megabytes / (ms / 1000.0) << " MB/s" << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        };
+        
+        /// Синхронная запись: ofstream::write на каждую пачку
+        {
+            const auto path = directory / "async_writer_ofstream.bin";
+            const double ms = benchmark::measure_ms([&]
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                for (size_t i = 0; i < batches; ++i)
+                {
+                    const auto span = produce(i);
+                    file.write(reinterpret_cast<const char*>(span.data()), static_cast<std::streamsize>(span.size_bytes()));
+                }
+                file.flush();
+            }, 3);
+            report("std::ofstream", ms);
+            std::filesystem::remove(path);
+        }
+        
+        /// Асинхронная запись: io_uring (если доступен) и пул потоков
+        for (const bool use_io_uring : {true, false})
+        {
+            const auto path = directory / "async_writer.bin";
+            AsyncWriter::Options options;
+            options.use_io_uring = use_io_uring;
+            
+            std::string backend;
+            const double ms = benchmark::measure_ms([&]
+            {
+                AsyncWriter writer(path, options);
+                for (size_t i = 0; i < batches; ++i)
+                    writer.write(produce(i));
+                writer.flush();
+                backend = writer.backend();
+            }, 3);
+            report(("AsyncWriter: " + backend).c_str(), ms);
+            
+            const bool valid = std::filesystem::file_size(path) == batch * batches * sizeof(Record);
+            std::filesystem::remove(path);
+            if (!valid)
+                std::cout << "Неверный размер файла" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
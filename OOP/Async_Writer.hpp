@@ -0,0 +1,87 @@
+#ifndef Async_Writer_hpp
+#define Async_Writer_hpp
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/*
+ Асинхронная запись потока POD записей в файл.
+ Блокирующий write() на каждую пачку записей останавливает конвейер, поэтому записи копируются (coalescing) в большие выровненные буферы, а заполненный буфер отправляется на запись в фоне:
+ - Linux: io_uring (кольца отправки/завершения общие с ядром, системный вызов на буфер, а не на пачку), если ядро его поддерживает;
+ - иначе: пул потоков с позиционной записью pwrite (Windows: WriteFile с OVERLAPPED смещением).
+ Каждый буфер получает смещение в файле при отправке, поэтому буферы можно писать в любом порядке и параллельно.
+ Обратное давление (back-pressure): буферов не больше max_in_flight, при их нехватке write() ждет завершения записи.
+ */
+namespace async_writer
+{
+    class AsyncWriter
+    {
+    public:
+        struct Options
+        {
+            size_t buffer_size = 1 << 20;  // 1 MiB
+            size_t max_in_flight = 8;      // буферов одновременно в записи
+            size_t threads = 2;            // потоков записи для пула
+            bool use_io_uring = true;
+        };
+        
+        explicit AsyncWriter(const std::filesystem::path& path);
+        AsyncWriter(const std::filesystem::path& path, const Options& options);
+        ~AsyncWriter();
+        
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+        
+        template <class T>
+        void write(std::span<const T> records)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "AsyncWriter пишет записи побайтово: нужен trivially copyable тип");
+            write_bytes(records.data(), records.size_bytes());
+        }
+        
+        void write_bytes(const void* data, size_t size);
+        /// Отправляет неполный буфер и ждет завершения всех записей; ошибки записи выбрасываются отсюда
+        void flush();
+        /// flush + сброс данных файла на диск (fsync)
+        void sync();
+        
+        const char* backend() const noexcept;
+        std::uint64_t bytes_written() const noexcept { return _offset; }
+    
+    private:
+        struct Buffer;
+        class File;
+        class Backend;
+        class ThreadPoolBackend;
+        class IoUringBackend;
+        
+        Buffer* acquire();
+        void submit_current();
+        void complete(Buffer& buffer, int error);
+        
+        Options _options;
+        std::unique_ptr<File> _file;
+        std::vector<std::unique_ptr<Buffer>> _buffers;
+        std::unique_ptr<Backend> _backend;
+        
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::vector<Buffer*> _free;
+        size_t _in_flight = 0;
+        int _error = 0;
+        
+        Buffer* _current = nullptr;
+        std::uint64_t _offset = 0;
+    };
+    
+    void Start();
+}
+
+#endif /* Async_Writer_hpp */
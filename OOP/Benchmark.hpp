@@ -0,0 +1,90 @@
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+ Общие помощники для замеров времени в примерах.
+ Замер повторяется несколько раз и берется лучший результат - так меньше влияние планировщика и прогрева кэшей.
+ */
+namespace benchmark
+{
+    class Timer
+    {
+    public:
+        Timer() : _start(std::chrono::steady_clock::now()) {}
+        
+        void reset()
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+        
+        double elapsed_ns() const
+        {
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _start).count();
+        }
+        
+        double elapsed_ms() const
+        {
+            return elapsed_ns() / 1'000'000.0;
+        }
+    
+    private:
+        std::chrono::steady_clock::time_point _start;
+    };
+    
+    /// Запрещает компилятору выбросить вычисление значения
+    template <class T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+        (void)*sink;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+    
+    /// Запрещает компилятору переупорядочивать обращения к памяти вокруг этой точки
+    inline void clobber_memory()
+    {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+    
+    /// Лучшее время (нс) из repeats запусков функции
+    template <class Function>
+    double measure_ns(Function&& function, size_t repeats = 5)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            Timer timer;
+            function();
+            clobber_memory();
+            best = std::min(best, timer.elapsed_ns());
+        }
+        return best;
+    }
+    
+    /// Лучшее время (мс) из repeats запусков функции
+    template <class Function>
+    double measure_ms(Function&& function, size_t repeats = 5)
+    {
+        return measure_ns(std::forward<Function>(function), repeats) / 1'000'000.0;
+    }
+}
+
+#endif /* Benchmark_hpp */
@@ -0,0 +1,408 @@
+#include "Checkpoint.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CHECKPOINT_MPROTECT
+#endif
+
+/*
+ Сайты: https://man7.org/linux/man-pages/man2/mprotect.2.html
+        https://learn.microsoft.com/ru-ru/windows/win32/api/memoryapi/nf-memoryapi-getwritewatch
+        https://habr.com/ru/articles/150093/
+ */
+
+namespace checkpoint
+{
+    namespace
+    {
+        constexpr char magic[8] = {'P', 'O', 'D', 'S', 'N', 'A', 'P', '1'};
+        
+        struct Header
+        {
+            char magic[8];
+            std::uint64_t page_size;
+            std::uint64_t size;
+        };
+
+#if defined(CHECKPOINT_MPROTECT)
+        /*
+         Обработчик сигнала не может брать mutex и выделять память, поэтому области хранятся в статическом массиве.
+         Регистрация публикует область через release-запись begin, обработчик читает ее через acquire.
+         */
+        struct Region
+        {
+            std::atomic<char*> begin{nullptr};
+            size_t size = 0;
+            size_t page_size = 0;
+            std::atomic<std::uint8_t>* dirty = nullptr;
+        };
+        
+        constexpr size_t max_regions = 64;
+        Region regions[max_regions];
+        std::mutex regions_mutex;
+        
+        struct sigaction previous_segv;
+        struct sigaction previous_bus;
+        
+        void on_write_fault(int signal, siginfo_t* info, void* context)
+        {
+            char* address = static_cast<char*>(info->si_addr);
+            for (auto& region : regions)
+            {
+                char* begin = region.begin.load(std::memory_order_acquire);
+                if (begin != nullptr && address >= begin && address < begin + region.size)
+                {
+                    const size_t page = static_cast<size_t>(address - begin) / region.page_size;
+                    region.dirty[page].store(1, std::memory_order_relaxed);
+                    mprotect(begin + page * region.page_size, region.page_size, PROT_READ | PROT_WRITE);
+                    return; // инструкция записи выполнится повторно, уже без ловушки
+                }
+            }
+            // Чужая ошибка доступа: ее разбирает прежний обработчик (санитайзер, обработчик программы), а этот остается установленным для следующих снимков
+            const struct sigaction& previous = signal == SIGSEGV ? previous_segv : previous_bus;
+            if ((previous.sa_flags & SA_SIGINFO) != 0)
+                previous.sa_sigaction(signal, info, context);
+            else if (previous.sa_handler == SIG_DFL)
+                ::signal(signal, SIG_DFL); // повторная инструкция завершит процесс как обычно
+            else if (previous.sa_handler != SIG_IGN)
+                previous.sa_handler(signal);
+        }
+        
+        void install_handler()
+        {
+            static std::once_flag once;
+            std::call_once(once, []
+            {
+                struct sigaction action = {};
+                action.sa_sigaction = on_write_fault;
+                action.sa_flags = SA_SIGINFO | SA_RESTART;
+                sigemptyset(&action.sa_mask);
+                sigaction(SIGSEGV, &action, &previous_segv);
+                sigaction(SIGBUS, &action, &previous_bus); // macOS сообщает о записи в защищенную страницу через SIGBUS
+            });
+        }
+        
+        void register_region(char* begin, size_t size, size_t page_size, std::atomic<std::uint8_t>* dirty)
+        {
+            install_handler();
+            std::lock_guard lock(regions_mutex);
+            for (auto& region : regions)
+            {
+                if (region.begin.load(std::memory_order_relaxed) == nullptr)
+                {
+                    region.size = size;
+                    region.page_size = page_size;
+                    region.dirty = dirty;
+                    region.begin.store(begin, std::memory_order_release);
+                    return;
+                }
+            }
+            throw std::runtime_error("checkpoint: слишком много отслеживаемых областей");
+        }
+        
+        void unregister_region(char* begin)
+        {
+            std::lock_guard lock(regions_mutex);
+            for (auto& region : regions)
+            {
+                if (region.begin.load(std::memory_order_relaxed) == begin)
+                    region.begin.store(nullptr, std::memory_order_release);
+            }
+        }
+#endif
+    }
+    
+    size_t DirtyPageTracker::system_page_size()
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#elif defined(CHECKPOINT_MPROTECT)
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+    
+    DirtyPageTracker::DirtyPageTracker(size_t bytes) : _page_size(system_page_size())
+    {
+        _size = std::max<size_t>(1, (bytes + _page_size - 1) / _page_size) * _page_size;
+#if defined(_WIN32)
+        _data = VirtualAlloc(nullptr, _size, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE);
+        if (_data == nullptr)
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "VirtualAlloc");
+#elif defined(CHECKPOINT_MPROTECT)
+        _data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (_data == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        _dirty = std::make_unique<std::atomic<std::uint8_t>[]>(page_count());
+        register_region(static_cast<char*>(_data), _size, _page_size, _dirty.get());
+#else
+        _data = std::calloc(_size, 1);
+        if (_data == nullptr)
+            throw std::bad_alloc();
+#endif
+    }
+    
+    DirtyPageTracker::~DirtyPageTracker()
+    {
+#if defined(_WIN32)
+        VirtualFree(_data, 0, MEM_RELEASE);
+#elif defined(CHECKPOINT_MPROTECT)
+        unregister_region(static_cast<char*>(_data));
+        munmap(_data, _size);
+#else
+        std::free(_data);
+#endif
+    }
+    
+    void DirtyPageTracker::start_tracking()
+    {
+#if defined(_WIN32)
+        ResetWriteWatch(_data, _size);
+#elif defined(CHECKPOINT_MPROTECT)
+        for (size_t i = 0, count = page_count(); i < count; ++i)
+            _dirty[i].store(0, std::memory_order_relaxed);
+        if (mprotect(_data, _size, PROT_READ) != 0)
+            throw std::system_error(errno, std::generic_category(), "mprotect");
+#endif
+        _tracking = true;
+    }
+    
+    void DirtyPageTracker::stop_tracking()
+    {
+#if defined(CHECKPOINT_MPROTECT)
+        if (_tracking && mprotect(_data, _size, PROT_READ | PROT_WRITE) != 0)
+            throw std::system_error(errno, std::generic_category(), "mprotect");
+#endif
+        _tracking = false;
+    }
+    
+    std::vector<size_t> DirtyPageTracker::collect_dirty()
+    {
+        std::vector<size_t> pages;
+        if (!_tracking)
+        {
+            // Без отслеживания любая страница могла измениться
+            pages.resize(page_count());
+            for (size_t i = 0; i < pages.size(); ++i)
+                pages[i] = i;
+            start_tracking();
+            return pages;
+        }
+#if defined(_WIN32)
+        std::vector<PVOID> addresses(page_count());
+        ULONG_PTR count = addresses.size();
+        DWORD granularity = 0;
+        if (GetWriteWatch(WRITE_WATCH_FLAG_RESET, _data, _size, addresses.data(), &count, &granularity) != 0)
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "GetWriteWatch");
+        pages.reserve(count);
+        for (ULONG_PTR i = 0; i < count; ++i)
+            pages.push_back((static_cast<char*>(addresses[i]) - static_cast<char*>(_data)) / _page_size);
+#elif defined(CHECKPOINT_MPROTECT)
+        char* begin = static_cast<char*>(_data);
+        for (size_t i = 0, count = page_count(); i < count; ++i)
+        {
+            if (_dirty[i].exchange(0, std::memory_order_relaxed) != 0)
+                pages.push_back(i);
+        }
+        // Снова защищаем грязные страницы, соседние - одним вызовом mprotect
+        for (size_t i = 0; i < pages.size();)
+        {
+            size_t j = i + 1;
+            while (j < pages.size() && pages[j] == pages[j - 1] + 1)
+                ++j;
+            if (mprotect(begin + pages[i] * _page_size, (j - i) * _page_size, PROT_READ) != 0)
+                throw std::system_error(errno, std::generic_category(), "mprotect");
+            i = j;
+        }
+#else
+        pages.resize(page_count());
+        for (size_t i = 0; i < pages.size(); ++i)
+            pages[i] = i;
+#endif
+        return pages;
+    }
+    
+    Snapshot::Snapshot(DirtyPageTracker& region, std::filesystem::path path) : _region(region), _path(std::move(path))
+    {
+    }
+    
+    Snapshot::Statistic Snapshot::save()
+    {
+        Statistic statistic;
+        const size_t page_size = _region.page_size();
+        const char* data = static_cast<const char*>(_region.data());
+        
+        if (!_has_base)
+        {
+            std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+                throw std::runtime_error("checkpoint: не удалось создать " + _path.string());
+            
+            // Заголовок занимает целую страницу, чтобы данные в файле лежали по границе страниц
+            std::vector<char> header_page(page_size);
+            Header header{};
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.page_size = page_size;
+            header.size = _region.size();
+            std::memcpy(header_page.data(), &header, sizeof(header));
+            
+            _region.start_tracking(); // до записи: изменения во время сохранения попадут в следующий снимок
+            file.write(header_page.data(), static_cast<std::streamsize>(header_page.size()));
+            file.write(data, static_cast<std::streamsize>(_region.size()));
+            if (!file)
+                throw std::runtime_error("checkpoint: ошибка записи " + _path.string());
+            
+            _has_base = true;
+            statistic.pages_written = _region.page_count();
+            statistic.bytes_written = _region.size();
+            statistic.writes = 1;
+            return statistic;
+        }
+        
+        const auto pages = _region.collect_dirty();
+        if (pages.empty())
+            return statistic;
+        
+        std::fstream file(_path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+            throw std::runtime_error("checkpoint: не удалось открыть " + _path.string());
+        
+        // Соседние грязные страницы пишутся одной операцией
+        for (size_t i = 0; i < pages.size();)
+        {
+            size_t j = i + 1;
+            while (j < pages.size() && pages[j] == pages[j - 1] + 1)
+                ++j;
+            
+            const size_t offset = pages[i] * page_size;
+            const size_t bytes = (j - i) * page_size;
+            file.seekp(static_cast<std::streamoff>(page_size + offset));
+            file.write(data + offset, static_cast<std::streamsize>(bytes));
+            
+            statistic.pages_written += j - i;
+            statistic.bytes_written += bytes;
+            ++statistic.writes;
+            i = j;
+        }
+        if (!file)
+            throw std::runtime_error("checkpoint: ошибка записи " + _path.string());
+        return statistic;
+    }
+    
+    void Snapshot::restore()
+    {
+        std::ifstream file(_path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("checkpoint: нет файла снимка " + _path.string());
+        
+        Header header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || std::memcmp(header.magic, magic, sizeof(magic)) != 0
+            || header.page_size != _region.page_size() || header.size != _region.size())
+            throw std::runtime_error("checkpoint: файл снимка не подходит к области " + _path.string());
+        
+        // Ядро не вызывает обработчик сигнала при чтении в защищенную память (read вернет EFAULT), поэтому защита снимается
+        _region.stop_tracking();
+        file.seekg(static_cast<std::streamoff>(header.page_size));
+        file.read(static_cast<char*>(_region.data()), static_cast<std::streamsize>(_region.size()));
+        if (!file)
+            throw std::runtime_error("checkpoint: ошибка чтения " + _path.string());
+        _region.start_tracking(); // память совпадает со снимком - грязных страниц нет
+        
+        _has_base = true;
+    }
+    
+    void Start()
+    {
+        std::cout << "checkpoint" << std::endl;
+        
+        struct Record // POD: 32 байта
+        {
+            std::int64_t id;
+            double price;
+            std::int32_t quantity;
+            std::int32_t flags;
+            std::int64_t timestamp;
+        };
+        
+        constexpr size_t records = 2 * 1024 * 1024; // 64 MiB, для реальной нагрузки можно увеличить до гигабайт
+        const auto path = std::filesystem::temp_directory_path() / "checkpoint_pod_array.bin";
+        
+        PodArray<Record> array(records);
+        for (size_t i = 0; i < array.size(); ++i)
+            array[i] = Record{static_cast<std::int64_t>(i), 1.0, 1, 0, 0};
+        
+        Snapshot snapshot(array.tracker(), path);
+        benchmark::Timer timer;
+        snapshot.save();
+        std::cout << "Полный снимок " << (array.tracker().size() >> 20) << " MiB: " << timer.elapsed_ms() << " ms" << std::endl;
+        
+        // Для сравнения: полная копия через memcpy + запись всего массива
+        {
+            std::vector<Record> copy(array.size());
+            const double full_ms = benchmark::measure_ms([&]
+            {
+                std::memcpy(copy.data(), array.data(), array.size() * sizeof(Record));
+                std::ofstream file(path.string() + ".full", std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(copy.data()), static_cast<std::streamsize>(copy.size() * sizeof(Record)));
+            }, 3);
+            std::filesystem::remove(path.string() + ".full");
+            std::cout << "memcpy + полная запись: " << full_ms << " ms" << std::endl;
+        }
+        
+        /*
+         Время инкрементального снимка растет с долей грязных страниц.
+         Отдельно показана цена первой записи в защищенную страницу (ловушка + mprotect) - ее платит рабочий поток.
+         */
+        const size_t pages = array.tracker().page_count();
+        const size_t records_per_page = array.tracker().page_size() / sizeof(Record);
+        std::cout << std::setw(8) << "dirty %" << std::setw(10) << "pages" << std::setw(16) << "faults ms" << std::setw(16) << "checkpoint ms" << std::setw(12) << "MiB" << std::endl;
+        for (const size_t percent : {0, 1, 5, 10, 25, 50, 100})
+        {
+            timer.reset();
+            for (size_t page = 0; page < pages; ++page)
+            {
+                if (page * percent / 100 != (page + 1) * percent / 100) // равномерно percent% страниц
+                    array[std::min(page * records_per_page, array.size() - 1)].flags += 1;
+            }
+            const double faults_ms = timer.elapsed_ms();
+            
+            timer.reset();
+            const auto statistic = snapshot.save();
+            const double checkpoint_ms = timer.elapsed_ms();
+            
+            std::cout << std::setw(8) << percent << std::setw(10) << statistic.pages_written << std::setw(16) << faults_ms
+                      << std::setw(16) << checkpoint_ms << std::setw(12) << (statistic.bytes_written >> 20) << std::endl;
+        }
+        
+        // Восстановление: портим данные и возвращаемся к последнему снимку
+        {
+            const Record expected = array[records / 2];
+            array[records / 2].price = -1.0;
+            snapshot.restore();
+            std::cout << "restore: " << (std::memcmp(&array[records / 2], &expected, sizeof(Record)) == 0 ? "OK" : "FAIL") << std::endl;
+        }
+        
+        std::filesystem::remove(path);
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef Checkpoint_hpp
+#define Checkpoint_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/*
+ Инкрементальный checkpoint (снимок) больших массивов POD.
+ Полное копирование (memcpy) многогигабайтного массива останавливает сервис, поэтому запоминаются только измененные (грязные) страницы памяти:
+ - Linux/macOS: страницы защищаются от записи (mprotect), первая запись вызывает SIGSEGV/SIGBUS, обработчик помечает страницу грязной и снимает защиту - последующие записи в ту же страницу бесплатны.
+ - Windows: память выделяется с флагом MEM_WRITE_WATCH, грязные страницы возвращает GetWriteWatch.
+ В файл снимка пишутся только грязные страницы по их смещению, поэтому файл всегда содержит полный образ массива и из него можно восстановиться.
+ Ограничение: снимок нужно делать в точке, где никто не пишет в массив (между запросами).
+ */
+namespace checkpoint
+{
+    /// Страничная область памяти с отслеживанием записи
+    class DirtyPageTracker
+    {
+    public:
+        explicit DirtyPageTracker(size_t bytes);
+        ~DirtyPageTracker();
+        
+        DirtyPageTracker(const DirtyPageTracker&) = delete;
+        DirtyPageTracker& operator=(const DirtyPageTracker&) = delete;
+        
+        void* data() const noexcept { return _data; }
+        size_t size() const noexcept { return _size; }
+        size_t page_size() const noexcept { return _page_size; }
+        size_t page_count() const noexcept { return _size / _page_size; }
+        
+        /// Сбрасывает грязные страницы и начинает отслеживать запись
+        void start_tracking();
+        /// Перестает отслеживать запись: вся память снова доступна без ловушек
+        void stop_tracking();
+        /// Возвращает индексы измененных страниц и снова защищает их от записи
+        std::vector<size_t> collect_dirty();
+        
+        static size_t system_page_size();
+    
+    private:
+        void* _data = nullptr;
+        size_t _size = 0;
+        size_t _page_size = 0;
+        bool _tracking = false;
+        std::unique_ptr<std::atomic<std::uint8_t>[]> _dirty; // POSIX: заполняется обработчиком сигнала
+    };
+    
+    /// Массив тривиально копируемых объектов в отслеживаемой памяти
+    template <class T>
+    class PodArray
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "checkpoint хранит объекты побайтово: нужен trivially copyable тип");
+    
+    public:
+        explicit PodArray(size_t count) : _tracker(count * sizeof(T)), _count(count)
+        {
+            // Память от ОС уже заполнена нулями - для trivially copyable это валидные объекты
+        }
+        
+        T& operator[](size_t index) noexcept { return data()[index]; }
+        const T& operator[](size_t index) const noexcept { return data()[index]; }
+        
+        T* data() noexcept { return static_cast<T*>(_tracker.data()); }
+        const T* data() const noexcept { return static_cast<const T*>(_tracker.data()); }
+        size_t size() const noexcept { return _count; }
+        
+        DirtyPageTracker& tracker() noexcept { return _tracker; }
+    
+    private:
+        DirtyPageTracker _tracker;
+        size_t _count;
+    };
+    
+    /// Файл снимка: заголовок + полный образ отслеживаемой области
+    class Snapshot
+    {
+    public:
+        struct Statistic
+        {
+            size_t pages_written = 0;
+            size_t bytes_written = 0;
+            size_t writes = 0; // количество операций записи (соседние страницы склеиваются)
+        };
+        
+        Snapshot(DirtyPageTracker& region, std::filesystem::path path);
+        
+        /// Первый вызов пишет всю область, последующие - только грязные страницы
+        Statistic save();
+        /// Восстанавливает область из файла снимка
+        void restore();
+        
+        const std::filesystem::path& path() const noexcept { return _path; }
+    
+    private:
+        DirtyPageTracker& _region;
+        std::filesystem::path _path;
+        bool _has_base = false;
+    };
+    
+    void Start();
+}
+
+#endif /* Checkpoint_hpp */
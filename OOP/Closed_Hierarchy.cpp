@@ -0,0 +1,208 @@
+#include "Closed_Hierarchy.hpp"
+#include "Benchmark.hpp"
+#include "Perf_Counter.hpp"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+ Сайты: https://www.foonathan.net/2020/06/closed-hierarchy/
+        https://en.wikipedia.org/wiki/Branch_table
+        https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+ */
+
+namespace closed_hierarchy
+{
+    namespace
+    {
+        /// Базовая линия: открытая иерархия с vptr
+        namespace virtual_dispatch
+        {
+            struct Base
+            {
+                explicit Base(int data) : data(data) {}
+                virtual ~Base() = default;
+                virtual int print(int number) const = 0;
+                
+                int data;
+            };
+            
+            struct Derived1 final : Base
+            {
+                using Base::Base;
+                int print(int number) const override { return number + data; }
+            };
+            
+            struct Derived2 final : Base
+            {
+                using Base::Base;
+                int print(int number) const override { return number * 2 - data; }
+            };
+            
+            struct Derived3 final : Base
+            {
+                using Base::Base;
+                int print(int number) const override { return (number ^ data) + 3; }
+            };
+            
+            struct Derived4 final : Base
+            {
+                using Base::Base;
+                int print(int number) const override { return (number + data) >> 1; }
+            };
+        }
+        
+        /// Закрытая иерархия: список типов объявлен один раз, методы невиртуальные
+        namespace closed_dispatch
+        {
+            struct Derived1;
+            struct Derived2;
+            struct Derived3;
+            struct Derived4;
+            
+            using Hierarchy = hierarchy<Derived1, Derived2, Derived3, Derived4>;
+            
+            struct Base
+            {
+                Hierarchy::kind_type kind() const noexcept { return _kind; }
+                
+                /// Аналог виртуального метода: switch по kind и прямой вызов
+                int print(int number) const;
+                
+                int data;
+            
+            protected:
+                Base(Hierarchy::kind_type kind, int data) : data(data), _kind(kind) {}
+            
+            private:
+                Hierarchy::kind_type _kind;
+            };
+            
+            struct Derived1 : Base
+            {
+                explicit Derived1(int data) : Base(Hierarchy::kind_of<Derived1>, data) {}
+                int print_impl(int number) const { return number + data; }
+            };
+            
+            struct Derived2 : Base
+            {
+                explicit Derived2(int data) : Base(Hierarchy::kind_of<Derived2>, data) {}
+                int print_impl(int number) const { return number * 2 - data; }
+            };
+            
+            struct Derived3 : Base
+            {
+                explicit Derived3(int data) : Base(Hierarchy::kind_of<Derived3>, data) {}
+                int print_impl(int number) const { return (number ^ data) + 3; }
+            };
+            
+            struct Derived4 : Base
+            {
+                explicit Derived4(int data) : Base(Hierarchy::kind_of<Derived4>, data) {}
+                int print_impl(int number) const { return (number + data) >> 1; }
+            };
+            
+            /// Определение после наследников: dispatch приводит Base к полным типам
+            inline int Base::print(int number) const
+            {
+                return Hierarchy::dispatch(*this, [number](const auto& derived) { return derived.print_impl(number); });
+            }
+            
+            /// Виртуального деструктора нет: удаление тоже через dispatch, по настоящему типу
+            struct Deleter
+            {
+                void operator()(Base* base) const
+                {
+                    Hierarchy::dispatch(*base, [](auto& derived) { delete &derived; });
+                }
+            };
+            
+            using Pointer = std::unique_ptr<Base, Deleter>;
+        }
+        
+        template <class Objects>
+        long long sum(const Objects& objects)
+        {
+            long long result = 0;
+            for (const auto& object : objects)
+                result += object->print(7);
+            return result;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "closed hierarchy" << std::endl;
+        
+        /// Вызов через switch вместо vptr
+        {
+            using namespace closed_dispatch;
+            const closed_dispatch::Pointer object(new Derived3(1));
+            std::cout << "kind: " << int(object->kind()) << ", print(10): " << object->print(10) << std::endl; // kind: 2, print(10): 14
+            std::cout << "sizeof(virtual Derived1): " << sizeof(virtual_dispatch::Derived1) << ", sizeof(closed Derived1): " << sizeof(Derived1) << std::endl; // 16, 8
+        }
+        
+        /*
+         1 млн объектов: один тип (переход всегда предсказан) и 4 типа в случайном порядке.
+         Промахи предсказателя переходов (perf_event_open, только Linux): у virtual промахивается косвенный вызов по vptr, у switch - переход по таблице (или условные переходы цепочки сравнений), но тело метода встроено.
+         */
+        {
+            constexpr size_t count = 1'000'000;
+            perf_counter::PerfCounter branch_misses(perf_counter::Event::branch_misses);
+            if (!branch_misses.available())
+                std::cout << "аппаратные счетчики недоступны: выводится только время" << std::endl;
+            
+            for (const size_t types : {size_t(1), size_t(4)})
+            {
+                std::mt19937 generator(11);
+                std::vector<std::unique_ptr<virtual_dispatch::Base>> virtuals;
+                std::vector<closed_dispatch::Pointer> closeds;
+                virtuals.reserve(count);
+                closeds.reserve(count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const int data = static_cast<int>(i % 1000);
+                    switch (generator() % types)
+                    {
+                        case 0:
+                            virtuals.push_back(std::make_unique<virtual_dispatch::Derived1>(data));
+                            closeds.emplace_back(new closed_dispatch::Derived1(data));
+                            break;
+                        case 1:
+                            virtuals.push_back(std::make_unique<virtual_dispatch::Derived2>(data));
+                            closeds.emplace_back(new closed_dispatch::Derived2(data));
+                            break;
+                        case 2:
+                            virtuals.push_back(std::make_unique<virtual_dispatch::Derived3>(data));
+                            closeds.emplace_back(new closed_dispatch::Derived3(data));
+                            break;
+                        default:
+                            virtuals.push_back(std::make_unique<virtual_dispatch::Derived4>(data));
+                            closeds.emplace_back(new closed_dispatch::Derived4(data));
+                            break;
+                    }
+                }
+                
+                long long virtual_sum = 0, closed_sum = 0;
+                const double virtual_ms = benchmark::measure_ms([&] { virtual_sum = sum(virtuals); benchmark::do_not_optimize(virtual_sum); });
+                const double closed_ms = benchmark::measure_ms([&] { closed_sum = sum(closeds); benchmark::do_not_optimize(closed_sum); });
+                const auto virtual_misses = branch_misses.measure([&] { benchmark::do_not_optimize(sum(virtuals)); });
+                const auto closed_misses = branch_misses.measure([&] { benchmark::do_not_optimize(sum(closeds)); });
+                
+                std::cout << "типов: " << types << (virtual_sum == closed_sum ? "" : " (суммы НЕ совпадают)") << std::endl;
+                std::cout << "  virtual: " << virtual_ms << " ms";
+                if (virtual_misses)
+                    std::cout << ", branch misses: " << *virtual_misses;
+                std::cout << std::endl;
+                std::cout << "  switch: " << closed_ms << " ms";
+                if (closed_misses)
+                    std::cout << ", branch misses: " << *closed_misses;
+                std::cout << std::endl;
+            }
+        }
+        
+        std::cout << std::endl;
+    }
+}
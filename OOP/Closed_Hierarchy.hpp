@@ -0,0 +1,112 @@
+#ifndef Closed_Hierarchy_hpp
+#define Closed_Hierarchy_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+ Диспетчеризация для закрытой иерархии: все наследники известны заранее (как в Virtual.cpp), поэтому список типов объявляется один раз - hierarchy<Derived...>.
+ Base хранит номер типа kind (1 байт) вместо vptr, а hierarchy::dispatch(base, function) разворачивается в switch по kind: компилятор строит таблицу переходов (jump table) или цепочку сравнений и вызывает невиртуальную реализацию напрямую.
+ Плюсы по сравнению с virtual:
+ - тело метода встраивается (inline) в место вызова;
+ - нет косвенного вызова через vptr, а значит и retpoline (-mindirect-branch=thunk, защита от Spectre v2) на каждый вызов; с retpoline компиляторы заменяют таблицу переходов цепочкой сравнений.
+ Минус: добавить наследника можно только изменив список типов и перекомпилировав все места вызова.
+ */
+namespace closed_hierarchy
+{
+    template <class T, class... Types>
+    constexpr size_t index_of() noexcept
+    {
+        constexpr bool matches[] = {std::is_same_v<T, Types>...};
+        for (size_t i = 0; i < sizeof...(Types); ++i)
+        {
+            if (matches[i])
+                return i;
+        }
+        return sizeof...(Types);
+    }
+    
+    [[noreturn]] inline void unreachable() noexcept
+    {
+#if defined(_MSC_VER)
+        __assume(false);
+#else
+        __builtin_unreachable();
+#endif
+    }
+    
+    template <class... Derived>
+    struct hierarchy
+    {
+        using kind_type = std::uint8_t;
+        
+        static_assert(sizeof...(Derived) > 0 && sizeof...(Derived) <= 256, "номер типа хранится в 1 байте");
+        
+        template <class T>
+        static constexpr kind_type kind_of = static_cast<kind_type>(index_of<T, Derived...>());
+        
+        template <size_t I>
+        using type_at = std::tuple_element_t<I, std::tuple<Derived...>>;
+        
+        template <class Base, class T>
+        using qualified = std::conditional_t<std::is_const_v<Base>, const T, T>;
+        
+        /// Результат function для первого наследника - общий для всех
+        template <class Base, class Function>
+        using result_type = decltype(std::declval<Function&>()(std::declval<qualified<Base, type_at<0>>&>()));
+        
+        /// function(Derived&) для динамического типа base; Base должен иметь kind()
+        template <class Base, class Function>
+        static result_type<Base, Function> dispatch(Base& base, Function&& function)
+        {
+            return dispatch_from<0>(base.kind(), base, function);
+        }
+    
+    private:
+        template <size_t I, class Base, class Function>
+        static result_type<Base, Function> call(Base& base, Function& function)
+        {
+            if constexpr (I < sizeof...(Derived))
+                return function(static_cast<qualified<Base, type_at<I>>&>(base));
+            else
+                unreachable();
+        }
+        
+        /// switch по 16 номерам за раз: для больших иерархий следующий switch в default
+        template <size_t Offset, class Base, class Function>
+        static result_type<Base, Function> dispatch_from(size_t kind, Base& base, Function& function)
+        {
+            switch (kind - Offset)
+            {
+                case 0:  return call<Offset + 0>(base, function);
+                case 1:  return call<Offset + 1>(base, function);
+                case 2:  return call<Offset + 2>(base, function);
+                case 3:  return call<Offset + 3>(base, function);
+                case 4:  return call<Offset + 4>(base, function);
+                case 5:  return call<Offset + 5>(base, function);
+                case 6:  return call<Offset + 6>(base, function);
+                case 7:  return call<Offset + 7>(base, function);
+                case 8:  return call<Offset + 8>(base, function);
+                case 9:  return call<Offset + 9>(base, function);
+                case 10: return call<Offset + 10>(base, function);
+                case 11: return call<Offset + 11>(base, function);
+                case 12: return call<Offset + 12>(base, function);
+                case 13: return call<Offset + 13>(base, function);
+                case 14: return call<Offset + 14>(base, function);
+                case 15: return call<Offset + 15>(base, function);
+                default:
+                    if constexpr (Offset + 16 < sizeof...(Derived))
+                        return dispatch_from<Offset + 16>(kind, base, function);
+                    else
+                        unreachable();
+            }
+        }
+    };
+    
+    void Start();
+}
+
+#endif /* Closed_Hierarchy_hpp */
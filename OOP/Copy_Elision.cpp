@@ -0,0 +1,251 @@
+#include "Copy_Elision.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#define COPY_ELISION_NOINLINE __declspec(noinline)
+#else
+#define COPY_ELISION_NOINLINE __attribute__((noinline))
+#endif
+
+/*
+ Сайты: https://habr.com/ru/companies/vk/articles/666330/
+        https://en.cppreference.com/w/cpp/language/copy_elision
+ */
+
+namespace copy_elision
+{
+    Payload::Payload(size_t size) : LifetimeProbe(size), _data(allocate(size)), _size(size)
+    {
+        std::memset(_data.get(), 1, _size);
+    }
+    
+    Payload::Payload(const Payload& other) : LifetimeProbe(other), _data(allocate(other._size)), _size(other._size)
+    {
+        std::memcpy(_data.get(), other._data.get(), _size);
+    }
+    
+    Payload& Payload::operator=(const Payload& other)
+    {
+        if (this != &other)
+        {
+            LifetimeProbe::operator=(other);
+            _data = allocate(other._size);
+            _size = other._size;
+            std::memcpy(_data.get(), other._data.get(), _size);
+        }
+        return *this;
+    }
+    
+    std::unique_ptr<std::byte[]> Payload::allocate(size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::unique_ptr<std::byte[]>(new std::byte[size]);
+    }
+    
+    /*
+     Функции не встраиваются (noinline), чтобы возврат шел через настоящую границу вызова, как в коде из разных единиц трансляции.
+     */
+    namespace RVO
+    {
+        COPY_ELISION_NOINLINE Payload function(size_t size)
+        {
+            return Payload(size);
+        }
+    }
+    
+    namespace NRVO
+    {
+        COPY_ELISION_NOINLINE Payload function(size_t size)
+        {
+            Payload payload(size);
+            return payload;
+        }
+        
+        COPY_ELISION_NOINLINE Payload function_move(size_t size)
+        {
+            Payload payload(size);
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpessimizing-move"
+#endif
+            return std::move(payload); // Так писать не стоит: NRVO отключается, остается перемещение
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+        }
+    }
+    
+    namespace NO_NRVO
+    {
+        COPY_ELISION_NOINLINE Payload function(Payload payload)
+        {
+            return payload; // параметр нельзя разместить на месте результата: неявное перемещение
+        }
+        
+        COPY_ELISION_NOINLINE Payload function_ref(const Payload& payload)
+        {
+            return payload; // копия
+        }
+    }
+    
+    bool nrvo_enabled()
+    {
+        Payload::Scope scope;
+        {
+            auto payload = NRVO::function(16);
+            benchmark::do_not_optimize(payload);
+        }
+        return scope.diff().moves() == 0;
+    }
+    
+    namespace
+    {
+        struct Result
+        {
+            double ns = 0;
+            double allocations = 0;
+            double copies = 0;
+            double moves = 0;
+        };
+        
+        /// call(size, source) -> Payload; source - готовый объект для шаблонов, которые принимают аргумент
+        template <class Call>
+        Result run(size_t size, Call&& call)
+        {
+            const Payload source(size);
+            const size_t iterations = std::clamp<size_t>((size_t(32) << 20) / size, 32, 20'000);
+            
+            Result result;
+            const size_t allocations_before = allocations.load(std::memory_order_relaxed);
+            Payload::Scope scope;
+            result.ns = benchmark::measure_ns([&]
+            {
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    auto payload = call(size, source);
+                    benchmark::do_not_optimize(payload.data());
+                }
+            }, 3) / double(iterations);
+            
+            const double calls = double(iterations) * 3;
+            const auto diff = scope.diff();
+            result.allocations = double(allocations.load(std::memory_order_relaxed) - allocations_before) / calls;
+            result.copies = double(diff.copies()) / calls;
+            result.moves = double(diff.moves()) / calls;
+            return result;
+        }
+        
+        struct Row
+        {
+            size_t size = 0;
+            std::string pattern;
+            Result result;
+        };
+        
+        /// Результаты сборки хранятся в текущем каталоге: copy_elision_elide.txt и copy_elision_no_elide.txt
+        std::string results_path(bool nrvo)
+        {
+            return nrvo ? "copy_elision_elide.txt" : "copy_elision_no_elide.txt";
+        }
+        
+        void save(const std::vector<Row>& rows, bool nrvo)
+        {
+            std::ofstream file(results_path(nrvo));
+            for (const Row& row : rows)
+                file << row.size << ' ' << row.pattern << ' ' << row.result.ns << ' ' << row.result.allocations << ' '
+                     << row.result.copies << ' ' << row.result.moves << '\n';
+        }
+        
+        std::vector<Row> load(bool nrvo)
+        {
+            std::vector<Row> rows;
+            std::ifstream file(results_path(nrvo));
+            Row row;
+            while (file >> row.size >> row.pattern >> row.result.ns >> row.result.allocations >> row.result.copies >> row.result.moves)
+                rows.push_back(row);
+            return rows;
+        }
+        
+        std::string size_name(size_t size)
+        {
+            if (size >= (1 << 20))
+                return std::to_string(size >> 20) + " MiB";
+            if (size >= (1 << 10))
+                return std::to_string(size >> 10) + " KiB";
+            return std::to_string(size) + " B";
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "copy elision" << std::endl;
+        
+        /*
+         Одна и та же программа собирается дважды:
+         - обычная сборка: NRVO работает, RVO::function и NRVO::function - одно выделение памяти на вызов, ни одного перемещения;
+         - конфигурация NoElide (Visual Studio, /Zc:nrvo-) или Release-NoElide (Xcode, -fno-elide-constructors): NRVO::function получает перемещение (дешево для вектора, но не бесплатно), RVO::function в C++17 не меняется.
+         Колонки в одной сборке уже сравнивают шаблоны между собой: копия (function_ref, function) - выделение памяти и memcpy всей нагрузки, т.е. время растет с размером, а перемещение от размера не зависит.
+         Каждый запуск сохраняет свою таблицу в файл; если в каталоге уже есть таблица другой сборки, печатается сравнение двух сборок рядом.
+         */
+        const bool nrvo = nrvo_enabled();
+        std::cout << "NRVO: " << (nrvo ? "применяется" : "не применяется (-fno-elide-constructors, /Zc:nrvo-)") << std::endl;
+        
+        const std::pair<const char*, Payload (*)(size_t, const Payload&)> patterns[] =
+        {
+            {"RVO::function", [](size_t size, const Payload&) { return RVO::function(size); }},
+            {"NRVO::function", [](size_t size, const Payload&) { return NRVO::function(size); }},
+            {"NRVO::function_move", [](size_t size, const Payload&) { return NRVO::function_move(size); }},
+            {"NO_NRVO::function", [](size_t, const Payload& source) { return NO_NRVO::function(source); }},
+            {"NO_NRVO::function_ref", [](size_t, const Payload& source) { return NO_NRVO::function_ref(source); }},
+        };
+        
+        std::cout << std::left << std::setw(10) << "size" << std::setw(24) << "pattern"
+                  << std::right << std::setw(14) << "ns/call" << std::setw(12) << "alloc/call"
+                  << std::setw(12) << "copy/call" << std::setw(12) << "move/call" << std::endl;
+        std::vector<Row> rows;
+        for (size_t size : {size_t(16), size_t(256), size_t(4) << 10, size_t(64) << 10, size_t(1) << 20})
+        {
+            for (const auto& [name, call] : patterns)
+            {
+                const auto result = run(size, call);
+                rows.push_back({size, name, result});
+                std::cout << std::left << std::setw(10) << size_name(size) << std::setw(24) << name
+                          << std::right << std::fixed << std::setprecision(1) << std::setw(14) << result.ns
+                          << std::setprecision(2) << std::setw(12) << result.allocations
+                          << std::setw(12) << result.copies << std::setw(12) << result.moves << std::endl;
+            }
+        }
+        
+        save(rows, nrvo);
+        const std::vector<Row> other = load(!nrvo);
+        if (other.size() != rows.size())
+            std::cout << "Для сравнения запустить сборку " << (nrvo ? "с -fno-elide-constructors (/Zc:nrvo-)" : "без -fno-elide-constructors")
+                      << " в этом же каталоге, таблица сохранена в " << results_path(nrvo) << std::endl;
+        else
+        {
+            // Сравнение сборок: с NRVO и без (таблица другой сборки - из ее последнего запуска)
+            const std::vector<Row>& elide = nrvo ? rows : other;
+            const std::vector<Row>& no_elide = nrvo ? other : rows;
+            std::cout << std::left << std::setw(10) << "size" << std::setw(24) << "pattern"
+                      << std::right << std::setw(14) << "ns elide" << std::setw(16) << "ns no elide"
+                      << std::setw(14) << "move elide" << std::setw(16) << "move no elide" << std::endl;
+            for (size_t i = 0; i < rows.size(); ++i)
+                std::cout << std::left << std::setw(10) << size_name(elide[i].size) << std::setw(24) << elide[i].pattern
+                          << std::right << std::fixed << std::setprecision(1) << std::setw(14) << elide[i].result.ns << std::setw(16) << no_elide[i].result.ns
+                          << std::setprecision(2) << std::setw(14) << elide[i].result.moves << std::setw(16) << no_elide[i].result.moves << std::endl;
+        }
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        
+        std::cout << std::endl;
+    }
+}
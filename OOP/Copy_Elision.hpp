@@ -0,0 +1,70 @@
+#ifndef Copy_Elision_hpp
+#define Copy_Elision_hpp
+
+#include "Lifetime_Probe.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/*
+ Замер шаблонов из RVO&NRVO.cpp: RVO, NRVO, NRVO испорченное std::move, возврат параметра по значению и возврат копии по ссылке.
+ Полезная нагрузка от 16 B до 1 MiB лежит в куче (std::vector), поэтому каждая копия - это выделение памяти + memcpy, а перемещение - обмен указателями.
+ Для каждого шаблона считается время, выделения памяти, копирования и перемещения на один вызов.
+ Сравнение сборок: обычная и с флагом -fno-elide-constructors (GCC/Clang; конфигурация Release-NoElide в Xcode) или /Zc:nrvo- (MSVC; конфигурация NoElide в Visual Studio).
+ Программа сама определяет, применяется ли NRVO, сохраняет таблицу в файл и, если рядом есть таблица другой сборки, печатает обе рядом.
+ В C++17 RVO для prvalue обязательна и не отключается даже флагом, флаг отключает только NRVO (и временные объекты до C++17).
+ */
+namespace copy_elision
+{
+    /// Счетчик выделений памяти полезной нагрузки
+    inline std::atomic<size_t> allocations{0};
+    
+    /*
+     Объект с полезной нагрузкой size байт в куче: копирование - выделение памяти + memcpy, перемещение - передача указателя.
+     Копирования/перемещения считает LifetimeProbe, выделения памяти - счетчик allocations.
+     */
+    class Payload : public lifetime_probe::LifetimeProbe<Payload>
+    {
+    public:
+        explicit Payload(size_t size);
+        Payload(const Payload& other);
+        Payload(Payload&& other) noexcept = default;
+        Payload& operator=(const Payload& other);
+        Payload& operator=(Payload&& other) noexcept = default;
+        ~Payload() = default;
+        
+        size_t size() const noexcept { return _size; }
+        const std::byte* data() const noexcept { return _data.get(); }
+    
+    private:
+        static std::unique_ptr<std::byte[]> allocate(size_t size);
+        
+        std::unique_ptr<std::byte[]> _data;
+        size_t _size = 0;
+    };
+    
+    namespace RVO
+    {
+        Payload function(size_t size);
+    }
+    
+    namespace NRVO
+    {
+        Payload function(size_t size);
+        Payload function_move(size_t size);
+    }
+    
+    namespace NO_NRVO
+    {
+        Payload function(Payload payload);
+        Payload function_ref(const Payload& payload);
+    }
+    
+    /// true - NRVO применяется, false - сборка с -fno-elide-constructors (или компилятор не смог применить NRVO)
+    bool nrvo_enabled();
+    
+    void Start();
+}
+
+#endif /* Copy_Elision_hpp */
@@ -0,0 +1,151 @@
+#include "Cow.hpp"
+#include "Benchmark.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ Сайты: https://en.wikipedia.org/wiki/Copy-on-write
+        https://doc.qt.io/qt-6/implicit-sharing.html
+ */
+
+namespace cow
+{
+    namespace
+    {
+        /// Большой объект-конфигурация: глубокая копия - десятки выделений памяти
+        struct Config
+        {
+            Config()
+            {
+                for (int i = 0; i < 64; ++i)
+                    entries.push_back({"option_" + std::to_string(i) + "_with_long_name", "value_" + std::to_string(i * i) + "_with_long_text"});
+            }
+            
+            std::string name = "service";
+            std::vector<std::pair<std::string, std::string>> entries;
+            int version = 0;
+        };
+        
+        /// Читатель получает копию конфигурации (как результат NO_NRVO::function_ref) и читает одно поле
+        template <class Handle, class Read>
+        size_t fan_out(const Handle& source, size_t readers, Read&& read)
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < readers; ++i)
+            {
+                Handle copy = source;
+                sum += read(copy).entries[i % 64].second.size();
+            }
+            return sum;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "cow" << std::endl;
+        
+        /// Копия разделяет содержимое до первой записи
+        {
+            cow<Config> first;
+            cow<Config> second = first;
+            std::cout << "use_count после копирования: " << first.use_count() << std::endl; // 2
+            
+            second.write().version = 2; // detach: глубокое копирование только здесь
+            std::cout << "use_count после записи: " << first.use_count() << ", version: " << first->version << " " << second->version << std::endl; // 1, 0 2
+        }
+        
+        /// Копии можно отдавать в другие потоки (atomic_policy)
+        {
+            cow<Config> config;
+            std::vector<std::thread> threads;
+            std::atomic<size_t> sum{0};
+            for (int i = 0; i < 4; ++i)
+            {
+                threads.emplace_back([copy = config, &sum]() mutable
+                {
+                    sum += copy->entries.size();
+                    copy.write().version = 1; // своя копия: оригинал не меняется
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            std::cout << "потоки прочитали: " << sum << " записей, version оригинала: " << config->version << std::endl; // 256, 0
+        }
+        
+        /*
+         Веерная раздача (fan-out) с редкой записью: 10000 читателей получают копию, каждые 1000 читателей конфигурация меняется.
+         - value: глубокая копия на каждого читателя;
+         - shared_ptr<const Config>: атомарный инкремент, запись - вручную make_shared<Config>(*old);
+         - cow / local_cow: инкремент (атомарный / обычный), запись - write().
+         Во время записи один читатель еще держит старую версию, поэтому shared_ptr и cow одинаково делают глубокую копию на каждую запись.
+         */
+        {
+            constexpr size_t readers = 1000;
+            constexpr size_t rounds = 10;
+            
+            const double value_ms = benchmark::measure_ms([&]
+            {
+                Config config;
+                size_t sum = 0;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    sum += fan_out(config, readers, [](const Config& copy) -> const Config& { return copy; });
+                    ++config.version;
+                }
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            
+            const double shared_ms = benchmark::measure_ms([&]
+            {
+                auto config = std::make_shared<const Config>();
+                size_t sum = 0;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    sum += fan_out(config, readers, [](const std::shared_ptr<const Config>& copy) -> const Config& { return *copy; });
+                    auto changed = std::make_shared<Config>(*config);
+                    ++changed->version;
+                    config = std::move(changed);
+                }
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            
+            const double cow_ms = benchmark::measure_ms([&]
+            {
+                cow<Config> config;
+                size_t sum = 0;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    sum += fan_out(config, readers, [](const cow<Config>& copy) -> const Config& { return *copy; });
+                    const cow<Config> snapshot = config; // читатель еще держит старую версию: write() копирует содержимое
+                    ++config.write().version;
+                }
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            
+            const double local_cow_ms = benchmark::measure_ms([&]
+            {
+                local_cow<Config> config;
+                size_t sum = 0;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    sum += fan_out(config, readers, [](const local_cow<Config>& copy) -> const Config& { return *copy; });
+                    const local_cow<Config> snapshot = config; // читатель еще держит старую версию: write() копирует содержимое
+                    ++config.write().version;
+                }
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            
+            std::cout << "fan-out " << readers * rounds << " читателей:" << std::endl;
+            std::cout << "value: " << value_ms << " ms" << std::endl;
+            std::cout << "shared_ptr<const T>: " << shared_ms << " ms" << std::endl;
+            std::cout << "cow (atomic): " << cow_ms << " ms" << std::endl;
+            std::cout << "cow (single thread): " << local_cow_ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
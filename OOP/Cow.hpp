@@ -0,0 +1,150 @@
+#ifndef Cow_hpp
+#define Cow_hpp
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+/*
+ COW (copy-on-write, копирование при записи) - копия объекта разделяет одно содержимое с оригиналом и увеличивает счетчик ссылок, а настоящее (глубокое) копирование откладывается до первой записи в разделяемое содержимое (detach).
+ Подходит для больших, часто копируемых и редко изменяемых объектов (конфигурации, справочники): возврат копии из NO_NRVO::function_ref стоит одного инкремента вместо глубокого копирования.
+ Политики счетчика ссылок:
+ - atomic_policy (по умолчанию): копии можно отдавать в другие потоки, как std::shared_ptr - разные объекты cow безопасно использовать из разных потоков, один и тот же объект - нет;
+ - single_thread_policy: обычный счетчик без атомарных операций - дешевле, но все копии должны жить в одном потоке.
+ В отличие от std::shared_ptr<const T>, запись не требует ручного «скопировать, изменить, заменить указатель»: write() сам копирует содержимое, только если оно разделяется.
+ Ссылка, полученная из read(), действительна до следующего write() этого же объекта.
+ */
+namespace cow
+{
+    struct atomic_policy
+    {
+        using counter = std::atomic<size_t>;
+        static constexpr bool concurrent = true; // копии живут в разных потоках
+        
+        static void increment(counter& references) noexcept { references.fetch_add(1, std::memory_order_relaxed); }
+        /// true - ссылка была последней
+        static bool decrement(counter& references) noexcept { return references.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+        static size_t load(const counter& references) noexcept { return references.load(std::memory_order_acquire); }
+    };
+    
+    /*
+     GCC 12 -O2 после встраивания не видит, что счетчик разделяемого содержимого больше 1, и считает, что release() другой копии мог его удалить,
+     поэтому предупреждает -Wuse-after-free на каждом ++/-- обычного счетчика. Атомарные операции этого анализа не проходят, предупреждение только здесь.
+     */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuse-after-free"
+#endif
+    struct single_thread_policy
+    {
+        using counter = size_t;
+        static constexpr bool concurrent = false;
+        
+        static void increment(counter& references) noexcept { ++references; }
+        static bool decrement(counter& references) noexcept { return --references == 0; }
+        static size_t load(const counter& references) noexcept { return references; }
+    };
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
+    
+    template <class T, class Policy = atomic_policy>
+    class cow
+    {
+    public:
+        template <class... Args>
+        explicit cow(std::in_place_t, Args&&... args) : _control(new Control(std::forward<Args>(args)...)) {}
+        
+        cow() : cow(std::in_place) {}
+        cow(const T& value) : cow(std::in_place, value) {}
+        cow(T&& value) : cow(std::in_place, std::move(value)) {}
+        
+        cow(const cow& other) noexcept : _control(other._control)
+        {
+            Policy::increment(_control->references);
+        }
+        
+        /// Перемещенный объект пуст: допустимы только присваивание и деструктор
+        cow(cow&& other) noexcept : _control(std::exchange(other._control, nullptr)) {}
+        
+        cow& operator=(const cow& other) noexcept
+        {
+            cow(other).swap(*this);
+            return *this;
+        }
+        
+        cow& operator=(cow&& other) noexcept
+        {
+            cow(std::move(other)).swap(*this);
+            return *this;
+        }
+        
+        ~cow()
+        {
+            release();
+        }
+        
+        void swap(cow& other) noexcept
+        {
+            std::swap(_control, other._control);
+        }
+        
+        const T& read() const noexcept
+        {
+            assert(_control);
+            return _control->value;
+        }
+        
+        const T& operator*() const noexcept { return read(); }
+        const T* operator->() const noexcept { return &read(); }
+        
+        /// Доступ на запись: если содержимое разделяется с другими копиями, сначала оно копируется
+        T& write()
+        {
+            assert(_control);
+            if (Policy::load(_control->references) != 1)
+            {
+                Control* shared = _control;
+                _control = new Control(shared->value);
+                [[maybe_unused]] const bool last = Policy::decrement(shared->references);
+                if constexpr (Policy::concurrent)
+                {
+                    if (last)
+                        delete shared; // копии в других потоках могли исчезнуть после проверки
+                }
+                else
+                    assert(!last); // в одном потоке счетчик после проверки не меняется: старое содержимое живет в других копиях
+            }
+            return _control->value;
+        }
+        
+        size_t use_count() const noexcept { return _control ? Policy::load(_control->references) : 0; }
+        bool unique() const noexcept { return use_count() == 1; }
+    
+    private:
+        struct Control
+        {
+            template <class... Args>
+            explicit Control(Args&&... args) : value(std::forward<Args>(args)...) {}
+            
+            typename Policy::counter references{1};
+            T value;
+        };
+        
+        void release() noexcept
+        {
+            if (_control && Policy::decrement(_control->references))
+                delete _control;
+        }
+        
+        Control* _control;
+    };
+    
+    template <class T>
+    using local_cow = cow<T, single_thread_policy>;
+    
+    void Start();
+}
+
+#endif /* Cow_hpp */
@@ -0,0 +1,222 @@
+#include "Dispatch.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/*
+ Сайты: https://johnysswlab.com/the-true-price-of-virtual-functions-in-c/
+        https://www.fluentcpp.com/2017/05/12/curiously-recurring-template-pattern/
+ */
+
+namespace dispatch
+{
+    namespace
+    {
+        constexpr size_t objects = 1 << 15;
+        constexpr size_t passes = 10;
+        
+        /// Место вызова: сколько разных типов и в каком порядке они идут
+        struct CallSite
+        {
+            size_t ways;
+            bool random;
+        };
+        
+        std::vector<std::uint8_t> make_types(const CallSite& site)
+        {
+            std::vector<std::uint8_t> types(objects);
+            for (size_t i = 0; i < objects; ++i)
+                types[i] = static_cast<std::uint8_t>(i % site.ways); // предсказуемый порядок: 0 1 2 ... 0 1 2
+            if (site.random)
+                std::shuffle(types.begin(), types.end(), std::mt19937(42));
+            return types;
+        }
+        
+        template <class Base, template <int> class Derived, size_t... I>
+        std::unique_ptr<Base> make_derived(size_t type, int data, std::index_sequence<I...>)
+        {
+            using Factory = std::unique_ptr<Base> (*)(int);
+            static constexpr Factory factories[] = {[](int value) -> std::unique_ptr<Base>
+            {
+                auto object = std::make_unique<Derived<static_cast<int>(I)>>();
+                object->data = value;
+                return object;
+            }...};
+            return factories[type](data);
+        }
+        
+        template <size_t... I>
+        variant_dispatch::Object make_variant(size_t type, int data, std::index_sequence<I...>)
+        {
+            using Factory = variant_dispatch::Object (*)(int);
+            static constexpr Factory factories[] = {[](int value)
+            {
+                return variant_dispatch::Object(std::in_place_index<I>, variant_dispatch::Derived<static_cast<int>(I)>{value});
+            }...};
+            return factories[type](data);
+        }
+        
+        /// ns на вызов: лучший из повторов прогон passes раз по всем объектам
+        template <class Pass>
+        double measure(Pass&& pass)
+        {
+            const double ns = benchmark::measure_ns([&]
+            {
+                long long sum = 0;
+                for (size_t i = 0; i < passes; ++i)
+                    sum += pass(static_cast<int>(i));
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            return ns / double(objects * passes);
+        }
+        
+        template <class Base>
+        double run_virtual(const std::vector<std::uint8_t>& types)
+        {
+            std::vector<std::unique_ptr<Base>> items;
+            items.reserve(types.size());
+            for (size_t i = 0; i < types.size(); ++i)
+            {
+                if constexpr (std::is_same_v<Base, virtual_dispatch::Base>)
+                    items.push_back(make_derived<Base, virtual_dispatch::Derived>(types[i], static_cast<int>(i), std::make_index_sequence<max_types>{}));
+                else
+                    items.push_back(make_derived<Base, final_dispatch::Derived>(types[i], static_cast<int>(i), std::make_index_sequence<max_types>{}));
+            }
+            return measure([&](int number)
+            {
+                long long sum = 0;
+                for (const auto& item : items)
+                    sum += item->print(number);
+                return sum;
+            });
+        }
+        
+        /// Мономорфное место вызова со статически известным final типом - вызов девиртуализируется и встраивается
+        double run_final_monomorphic()
+        {
+            std::vector<std::unique_ptr<final_dispatch::Derived<0>>> items;
+            for (size_t i = 0; i < objects; ++i)
+            {
+                items.push_back(std::make_unique<final_dispatch::Derived<0>>());
+                items.back()->data = static_cast<int>(i);
+            }
+            return measure([&](int number)
+            {
+                long long sum = 0;
+                for (const auto& item : items)
+                    sum += item->print(number);
+                return sum;
+            });
+        }
+        
+        /// CRTP: объекты лежат по типам (общего контейнера нет), порядок вызовов - по типам
+        template <size_t... I>
+        double run_crtp(const std::vector<std::uint8_t>& types, std::index_sequence<I...>)
+        {
+            std::tuple<std::vector<crtp_dispatch::Derived<static_cast<int>(I)>>...> segments;
+            for (size_t i = 0; i < types.size(); ++i)
+            {
+                ((types[i] == I ? (std::get<I>(segments).emplace_back().data = static_cast<int>(i), void()) : void()), ...);
+            }
+            return measure([&](int number)
+            {
+                long long sum = 0;
+                auto each = [&](const auto& segment)
+                {
+                    for (const auto& item : segment)
+                        sum += item.print(number);
+                };
+                (each(std::get<I>(segments)), ...);
+                return sum;
+            });
+        }
+        
+        double run_variant(const std::vector<std::uint8_t>& types)
+        {
+            std::vector<variant_dispatch::Object> items;
+            items.reserve(types.size());
+            for (size_t i = 0; i < types.size(); ++i)
+                items.push_back(make_variant(types[i], static_cast<int>(i), std::make_index_sequence<max_types>{}));
+            return measure([&](int number)
+            {
+                long long sum = 0;
+                for (const auto& item : items)
+                    sum += variant_dispatch::print(item, number);
+                return sum;
+            });
+        }
+        
+        double run_table(const std::vector<std::uint8_t>& types)
+        {
+            std::vector<table_dispatch::Object> items(types.size());
+            for (size_t i = 0; i < types.size(); ++i)
+                items[i] = {types[i], static_cast<int>(i)};
+            return measure([&](int number)
+            {
+                long long sum = 0;
+                for (const auto& item : items)
+                    sum += table_dispatch::print(item, number);
+                return sum;
+            });
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "dispatch" << std::endl;
+        
+        const CallSite sites[] = {{1, false}, {2, false}, {2, true}, {4, false}, {4, true}, {16, false}, {16, true}};
+        
+        std::cout << std::left << std::setw(16) << "ns/call" << std::right;
+        for (const auto& site : sites)
+            std::cout << std::setw(10) << (site.ways == 1 ? std::string("mono") : std::to_string(site.ways) + (site.random ? " rand" : " pred"));
+        std::cout << std::endl;
+        
+        std::vector<double> virtual_ns, final_ns, crtp_ns, variant_ns, table_ns;
+        for (const auto& site : sites)
+        {
+            const auto types = make_types(site);
+            virtual_ns.push_back(run_virtual<virtual_dispatch::Base>(types));
+            final_ns.push_back(site.ways == 1 ? run_final_monomorphic() : run_virtual<final_dispatch::Base>(types));
+            crtp_ns.push_back(site.random ? -1 : run_crtp(types, std::make_index_sequence<max_types>{}));
+            variant_ns.push_back(run_variant(types));
+            table_ns.push_back(run_table(types));
+        }
+        
+        auto print = [](const char* name, const std::vector<double>& results)
+        {
+            std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2);
+            for (double ns : results)
+            {
+                if (ns < 0)
+                    std::cout << std::setw(10) << "-";
+                else
+                    std::cout << std::setw(10) << ns;
+            }
+            std::cout << std::endl;
+        };
+        print("virtual", virtual_ns);
+        print("final+virtual", final_ns);
+        print("CRTP", crtp_ns);
+        print("variant+visit", variant_ns);
+        print("function table", table_ns);
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        
+        /*
+         final+virtual выигрывает только в мономорфном месте вызова со статически известным типом: через Base* это обычный virtual.
+         CRTP не умеет смешанный контейнер: объекты сгруппированы по типам, поэтому для случайного порядка замера нет (-), а «предсказуемый» порядок для него - порядок по типам.
+         variant и таблица функций хранят объекты по значению подряд (без указателя на кучу), но на случайном порядке тоже платят за ошибки предсказания перехода.
+         */
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef Dispatch_hpp
+#define Dispatch_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <variant>
+
+/*
+ Пять способов вызвать «print» иерархии Base/Derived из Virtual.cpp (вместо печати - дешевое вычисление, чтобы мерить сам вызов):
+ - virtual: вызов через vptr -> vtable -> косвенный переход (indirect call), встраивание невозможно;
+ - final + virtual: если статический тип известен (Derived final), компилятор девиртуализирует вызов и может встроить его. Через Base* - как обычный virtual;
+ - CRTP: полиморфизм на этапе компиляции, вызов прямой и встраивается, но у разных Derived нет общего базового типа - смешанный контейнер невозможен, объекты хранятся по типам;
+ - std::variant + std::visit: закрытый набор типов, объекты лежат по значению, visit - таблица переходов (switch) по индексу типа;
+ - таблица указателей на функции: объект хранит маленький индекс типа, вызов - table[type](object).
+ Стоимость косвенного вызова зависит от места вызова: мономорфное (всегда один тип) предсказатель переходов угадывает всегда, полиморфное с предсказуемым порядком - почти всегда, со случайным порядком - ошибается тем чаще, чем больше типов.
+ */
+namespace dispatch
+{
+    constexpr size_t max_types = 16;
+    
+    namespace virtual_dispatch
+    {
+        struct Base
+        {
+            virtual ~Base() = default;
+            virtual int print(int number) const = 0;
+            
+            int data = 0;
+        };
+        
+        template <int K>
+        struct Derived : Base
+        {
+            int print(int number) const override { return number * (K + 1) + data; }
+        };
+    }
+    
+    namespace final_dispatch
+    {
+        struct Base
+        {
+            virtual ~Base() = default;
+            virtual int print(int number) const = 0;
+            
+            int data = 0;
+        };
+        
+        template <int K>
+        struct Derived final : Base
+        {
+            int print(int number) const override { return number * (K + 1) + data; }
+        };
+    }
+    
+    namespace crtp_dispatch
+    {
+        template <class Derived>
+        struct Base
+        {
+            int print(int number) const { return static_cast<const Derived&>(*this).print_impl(number); }
+            
+            int data = 0;
+        };
+        
+        template <int K>
+        struct Derived : Base<Derived<K>>
+        {
+            int print_impl(int number) const { return number * (K + 1) + this->data; }
+        };
+    }
+    
+    namespace variant_dispatch
+    {
+        template <int K>
+        struct Derived
+        {
+            int print(int number) const { return number * (K + 1) + data; }
+            
+            int data = 0;
+        };
+        
+        template <class Sequence>
+        struct make_object;
+        
+        template <size_t... I>
+        struct make_object<std::index_sequence<I...>>
+        {
+            using type = std::variant<Derived<static_cast<int>(I)>...>;
+        };
+        
+        using Object = typename make_object<std::make_index_sequence<max_types>>::type;
+        
+        inline int print(const Object& object, int number)
+        {
+            return std::visit([number](const auto& derived) { return derived.print(number); }, object);
+        }
+    }
+    
+    namespace table_dispatch
+    {
+        /// Объект без vptr: индекс типа + данные
+        struct Object
+        {
+            std::uint8_t type = 0;
+            int data = 0;
+        };
+        
+        using Function = int (*)(const Object&, int);
+        
+        template <int K>
+        int print_impl(const Object& object, int number)
+        {
+            return number * (K + 1) + object.data;
+        }
+        
+        template <size_t... I>
+        constexpr std::array<Function, sizeof...(I)> make_table(std::index_sequence<I...>)
+        {
+            return {&print_impl<static_cast<int>(I)>...};
+        }
+        
+        inline constexpr auto table = make_table(std::make_index_sequence<max_types>{});
+        
+        inline int print(const Object& object, int number)
+        {
+            return table[object.type](object, number);
+        }
+    }
+    
+    void Start();
+}
+
+#endif /* Dispatch_hpp */
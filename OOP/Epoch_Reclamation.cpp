@@ -0,0 +1,408 @@
+#include "Epoch_Reclamation.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ Сайты: https://www.cl.cam.ac.uk/techreports/UCAM-CL-TR-579.pdf
+        https://aturon.github.io/blog/2015/08/27/epoch/
+        https://preshing.com/20160726/using-quiescent-states-to-reclaim-memory/
+ */
+
+namespace epoch_reclamation
+{
+    namespace
+    {
+        constexpr std::uint64_t inactive = std::numeric_limits<std::uint64_t>::max();
+        constexpr size_t scan_threshold = 64; // попытка освобождения на каждый 64-й retire
+        
+        struct Retired
+        {
+            std::uint64_t epoch;
+            void* object;
+            detail::Deleter deleter;
+        };
+        
+        /// Запись потока: эпоха читается всеми потоками, остальное - только владельцем
+        struct alignas(64) Record
+        {
+            std::atomic<std::uint64_t> epoch{inactive};
+            std::atomic<bool> in_use{true};
+            Record* next = nullptr;
+            
+            size_t nesting = 0;
+            size_t since_scan = 0;
+            std::vector<Retired> retired;
+        };
+        
+        class Domain
+        {
+        public:
+            ~Domain()
+            {
+                // Потоков-читателей больше нет: удаляется все, что осталось
+                for (const Retired& retired : _orphans)
+                    retired.deleter(retired.object);
+                for (Record* record = _head.load(); record;)
+                {
+                    for (const Retired& retired : record->retired)
+                        retired.deleter(retired.object);
+                    delete std::exchange(record, record->next);
+                }
+            }
+            
+            std::uint64_t epoch() const noexcept { return _epoch.load(std::memory_order_seq_cst); }
+            size_t pending() const noexcept { return _pending.load(std::memory_order_relaxed); }
+            
+            /// Свободная запись завершившегося потока или новая
+            Record* acquire()
+            {
+                for (Record* record = _head.load(std::memory_order_acquire); record; record = record->next)
+                {
+                    bool expected = false;
+                    if (record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        return record;
+                }
+                
+                auto* record = new Record;
+                record->next = _head.load(std::memory_order_relaxed);
+                while (!_head.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed));
+                return record;
+            }
+            
+            /// Поток завершается: неудаленные объекты переходят в общий список
+            void release(Record* record)
+            {
+                reclaim(record->retired);
+                if (!record->retired.empty())
+                {
+                    std::lock_guard lock(_mutex);
+                    _orphans.insert(_orphans.end(), record->retired.begin(), record->retired.end());
+                    record->retired.clear();
+                }
+                record->nesting = 0;
+                record->since_scan = 0;
+                record->epoch.store(inactive, std::memory_order_release);
+                record->in_use.store(false, std::memory_order_release);
+            }
+            
+            void retire(Record& record, void* object, detail::Deleter deleter)
+            {
+                record.retired.push_back({epoch(), object, deleter}); // эпоха читается после удаления объекта из структуры
+                _pending.fetch_add(1, std::memory_order_relaxed);
+                if (++record.since_scan >= scan_threshold)
+                {
+                    record.since_scan = 0;
+                    try_advance();
+                    reclaim(record.retired);
+                }
+            }
+            
+            /// Эпоха сдвигается, только если все активные потоки уже объявили текущую
+            bool try_advance() noexcept
+            {
+                std::uint64_t current = _epoch.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                for (Record* record = _head.load(std::memory_order_acquire); record; record = record->next)
+                {
+                    const std::uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+                    if (epoch != inactive && epoch != current)
+                        return false;
+                }
+                return _epoch.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+            }
+            
+            /// Удаление объектов, отложенных не позже эпохи epoch - 2
+            void reclaim(std::vector<Retired>& retired)
+            {
+                destroy(expired(retired));
+            }
+            
+            void reclaim_orphans()
+            {
+                std::vector<Retired> objects;
+                {
+                    std::lock_guard lock(_mutex);
+                    objects = expired(_orphans);
+                }
+                destroy(objects); // без блокировки: деструктор может сам вызвать retire
+            }
+        
+        private:
+            /// Объекты, которые можно удалить, переносятся из retired в отдельный список
+            std::vector<Retired> expired(std::vector<Retired>& retired)
+            {
+                const std::uint64_t current = _epoch.load(std::memory_order_acquire);
+                const auto end = std::partition(retired.begin(), retired.end(), [current](const Retired& object) { return object.epoch + 2 > current; });
+                std::vector<Retired> result(end, retired.end());
+                retired.erase(end, retired.end());
+                _pending.fetch_sub(result.size(), std::memory_order_relaxed);
+                return result;
+            }
+            
+            /// Виртуальный деструктор узла графа может вызвать retire для дочерних узлов: список retired потока в это время не обходится
+            static void destroy(const std::vector<Retired>& objects)
+            {
+                for (const Retired& retired : objects)
+                    retired.deleter(retired.object);
+            }
+            
+            alignas(64) std::atomic<std::uint64_t> _epoch{0};
+            std::atomic<Record*> _head{nullptr};
+            std::atomic<size_t> _pending{0};
+            std::mutex _mutex;
+            std::vector<Retired> _orphans;
+        };
+        
+        Domain& domain()
+        {
+            static Domain domain;
+            return domain;
+        }
+        
+        /// Запись текущего потока: берется при первом обращении и возвращается при завершении потока
+        struct ThreadRecord
+        {
+            ThreadRecord() : domain(epoch_reclamation::domain()), record(domain.acquire()) {}
+            ~ThreadRecord() { domain.release(record); }
+            
+            Domain& domain;
+            Record* record;
+        };
+        
+        Record& record()
+        {
+            thread_local ThreadRecord thread_record;
+            return *thread_record.record;
+        }
+    }
+    
+    guard::guard() noexcept
+    {
+        Record& record = epoch_reclamation::record();
+        if (record.nesting++ == 0)
+        {
+            record.epoch.store(domain().epoch(), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // объявление эпохи видно до чтения указателей
+        }
+    }
+    
+    guard::~guard()
+    {
+        Record& record = epoch_reclamation::record();
+        if (--record.nesting == 0)
+            record.epoch.store(inactive, std::memory_order_release);
+    }
+    
+    void detail::retire(void* object, Deleter deleter)
+    {
+        domain().retire(epoch_reclamation::record(), object, deleter);
+    }
+    
+    void collect()
+    {
+        Domain& domain = epoch_reclamation::domain();
+        Record& record = epoch_reclamation::record();
+        for (int i = 0; i < 2 && domain.try_advance(); ++i); // до 2 сдвигов: объекты текущей эпохи тоже становятся недоступны
+        domain.reclaim(record.retired);
+        domain.reclaim_orphans();
+    }
+    
+    size_t pending() noexcept
+    {
+        return domain().pending();
+    }
+    
+    namespace
+    {
+        std::atomic<size_t> destroyed{0};
+        
+        struct Base
+        {
+            virtual ~Base() { destroyed.fetch_add(1, std::memory_order_relaxed); }
+            virtual int value() const = 0;
+        };
+        
+        struct Derived1 final : Base
+        {
+            explicit Derived1(int data) : data(data) {}
+            int value() const override { return data; }
+            
+            int data;
+        };
+        
+        struct Derived2 final : Base
+        {
+            explicit Derived2(int data) : data(data) {}
+            int value() const override { return data * 2; }
+            
+            int data;
+        };
+        
+        /// Узел графа: деструктор откладывает удаление дочернего узла
+        struct Node final : Base
+        {
+            explicit Node(Base* child) : child(child) {}
+            ~Node() override
+            {
+                if (child != nullptr)
+                    retire(child);
+            }
+            int value() const override { return 0; }
+            
+            Base* child;
+        };
+        
+        Base* make_node(int data)
+        {
+            return data & 1 ? static_cast<Base*>(new Derived1(data)) : new Derived2(data);
+        }
+        
+        constexpr size_t slots = 64;
+        
+        /// threads читателей по reads чтений + писатель, который все это время заменяет объекты: нс на чтение
+        template <class Read, class Write>
+        double read_ns(size_t threads, size_t reads, Read&& read, Write&& write)
+        {
+            const double ns = benchmark::measure_ns([&]
+            {
+                std::atomic<size_t> running{threads};
+                std::thread writer([&]
+                {
+                    for (int i = 0; running.load(std::memory_order_acquire) != 0; ++i)
+                    {
+                        write(static_cast<size_t>(i) % slots, i);
+                        std::this_thread::yield();
+                    }
+                });
+                
+                std::vector<std::thread> readers;
+                for (size_t thread = 0; thread < threads; ++thread)
+                {
+                    readers.emplace_back([&, thread]
+                    {
+                        long long sum = 0;
+                        for (size_t i = 0; i < reads; ++i)
+                            sum += read((i * 7 + thread) % slots);
+                        benchmark::do_not_optimize(sum);
+                        running.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+                for (auto& reader : readers)
+                    reader.join();
+                writer.join();
+            }, 3);
+            return ns / double(threads * reads);
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "epoch reclamation" << std::endl;
+        
+        /// Замененный объект удаляется через виртуальный деструктор, только когда его больше не видит ни один читатель
+        {
+            std::atomic<Base*> node{make_node(1)};
+            const size_t before = destroyed.load();
+            {
+                guard reader;
+                const Base* current = node.load(std::memory_order_acquire);
+                retire(node.exchange(make_node(2), std::memory_order_acq_rel)); // писатель заменил объект
+                collect();
+                std::cout << "внутри guard: value " << current->value() << ", ждут удаления: " << pending() << std::endl; // value 1, ждут удаления: 1
+            }
+            collect();
+            std::cout << "после guard: ждут удаления " << pending() << ", удалено " << destroyed.load() - before << std::endl; // 0, 1
+            delete node.load();
+        }
+        
+        /// Деструктор вызывает retire во время удаления: цепочка из 1000 узлов удаляется по одному узлу за collect()
+        {
+            const size_t before = destroyed.load();
+            Base* head = nullptr;
+            for (int i = 0; i < 1000; ++i)
+                head = new Node(head);
+            retire(head);
+            for (int i = 0; i < 2000 && pending() != 0; ++i)
+                collect();
+            std::cout << "цепочка: удалено " << destroyed.load() - before << ", ждут удаления " << pending() << std::endl; // 1000, 0
+        }
+        
+        /*
+         Масштабирование чтения: 1/2/4 читателя по 200000 чтений из 64 ячеек, писатель все это время заменяет объекты.
+         - EBR: guard + атомарная загрузка указателя, общих записей нет;
+         - atomic<shared_ptr>: каждое чтение - инкремент и декремент счетчика объекта (и внутренняя блокировка в libstdc++);
+         - shared_mutex: читатели пишут в общий счетчик блокировки и ждут писателя.
+         */
+        {
+            constexpr size_t reads = 200'000;
+            
+            std::atomic<Base*> raw[slots];
+            std::atomic<std::shared_ptr<Base>> shared[slots];
+            Base* locked[slots];
+            std::shared_mutex mutex;
+            for (size_t i = 0; i < slots; ++i)
+            {
+                raw[i].store(make_node(int(i)));
+                shared[i].store(std::shared_ptr<Base>(make_node(int(i))));
+                locked[i] = make_node(int(i));
+            }
+            
+            for (const size_t threads : {size_t(1), size_t(2), size_t(4)})
+            {
+                const double ebr_ns = read_ns(threads, reads, [&](size_t slot)
+                {
+                    guard reader;
+                    return raw[slot].load(std::memory_order_acquire)->value();
+                }, [&](size_t slot, int data)
+                {
+                    retire(raw[slot].exchange(make_node(data), std::memory_order_acq_rel));
+                });
+                
+                const double shared_ns = read_ns(threads, reads, [&](size_t slot)
+                {
+                    return shared[slot].load(std::memory_order_acquire)->value();
+                }, [&](size_t slot, int data)
+                {
+                    shared[slot].store(std::shared_ptr<Base>(make_node(data)), std::memory_order_release);
+                });
+                
+                const double mutex_ns = read_ns(threads, reads, [&](size_t slot)
+                {
+                    std::shared_lock lock(mutex);
+                    return locked[slot]->value();
+                }, [&](size_t slot, int data)
+                {
+                    Base* node = make_node(data);
+                    {
+                        std::unique_lock lock(mutex);
+                        std::swap(locked[slot], node);
+                    }
+                    delete node;
+                });
+                
+                std::cout << "читателей: " << threads << ", EBR: " << ebr_ns << " ns, atomic<shared_ptr>: " << shared_ns
+                          << " ns, shared_mutex: " << mutex_ns << " ns на чтение" << std::endl;
+            }
+            
+            collect();
+            for (size_t i = 0; i < slots; ++i)
+            {
+                delete raw[i].load();
+                delete locked[i];
+            }
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef Epoch_Reclamation_hpp
+#define Epoch_Reclamation_hpp
+
+#include <cstddef>
+#include <type_traits>
+
+/*
+ Эпохальное освобождение памяти (EBR, epoch-based reclamation) для объектов, которые читатели обходят без блокировок, пока писатель их заменяет.
+ Подсчет ссылок на каждое чтение (shared_ptr) не масштабируется: все читатели пишут в один счетчик, и его кэш-линия прыгает между ядрами.
+ Схема:
+ - глобальная эпоха - счетчик; каждый поток при входе в критическую секцию чтения (guard) объявляет эпоху, которую видел, а при выходе - что он неактивен;
+ - писатель сначала убирает объект из структуры (атомарная замена указателя), затем вызывает retire(object): объект попадает в список ожидания потока с текущей эпохой;
+ - эпоха сдвигается, когда все активные потоки объявили текущую эпоху; объект, отложенный в эпохе e, удаляется после сдвига до e + 2 - к этому моменту ни один читатель не может держать на него указатель;
+ - удаление через delete T*, то есть через виртуальный деструктор Base, если retire получил Base*.
+ Чтение стоит 2 записи в собственную кэш-линию потока и барьер, без общих счетчиков. Цена - задержка освобождения: поток, надолго застрявший в guard, не дает удалить ничего.
+ Ограничения: указатели, прочитанные внутри guard, нельзя использовать после его завершения; guard можно вкладывать.
+ */
+namespace epoch_reclamation
+{
+    /// Критическая секция читателя
+    class guard
+    {
+    public:
+        guard() noexcept;
+        ~guard();
+        
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+    };
+    
+    namespace detail
+    {
+        using Deleter = void (*)(void* object);
+        
+        void retire(void* object, Deleter deleter);
+    }
+    
+    /// Отложенное удаление объекта, уже недоступного новым читателям
+    template <class T>
+    void retire(T* object)
+    {
+        static_assert(!std::is_polymorphic_v<T> || std::has_virtual_destructor_v<T>, "полиморфный объект удаляется через виртуальный деструктор");
+        detail::retire(const_cast<void*>(static_cast<const volatile void*>(object)), [](void* pointer) { delete static_cast<T*>(pointer); });
+    }
+    
+    /// Попытка сдвинуть эпоху и удалить объекты, которые больше никто не видит
+    void collect();
+    
+    /// Объектов ждут удаления (во всех потоках)
+    size_t pending() noexcept;
+    
+    void Start();
+}
+
+#endif /* Epoch_Reclamation_hpp */
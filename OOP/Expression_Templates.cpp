@@ -0,0 +1,148 @@
+#include "Expression_Templates.hpp"
+#include "Benchmark.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+/*
+ Сайты: https://en.wikipedia.org/wiki/Expression_templates
+        https://habr.com/ru/articles/444518/
+ */
+
+namespace expression_templates
+{
+    namespace eager
+    {
+        namespace
+        {
+            size_t allocations = 0; // сколько массивов (выделений памяти) создано
+            size_t traffic = 0;     // сколько элементов прочитано и записано операторами
+        }
+        
+        Array::Array(size_t size, double value) : _data(size, value)
+        {
+            ++allocations;
+        }
+        
+        Array operator+(const Array& left, const Array& right)
+        {
+            Array result(left.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = left[i] + right[i];
+            traffic += 3 * result.size(); // 2 операнда + результат
+            return result;
+        }
+        
+        Array operator-(const Array& left, const Array& right)
+        {
+            Array result(left.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = left[i] - right[i];
+            traffic += 3 * result.size(); // 2 операнда + результат
+            return result;
+        }
+        
+        Array operator*(const Array& left, const Array& right)
+        {
+            Array result(left.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = left[i] * right[i];
+            traffic += 3 * result.size(); // 2 операнда + результат
+            return result;
+        }
+        
+        Array operator*(const Array& left, double value)
+        {
+            Array result(left.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = left[i] * value;
+            traffic += 2 * result.size(); // операнд + результат
+            return result;
+        }
+    }
+    
+    namespace
+    {
+        /// Число массивов-операндов в дереве выражения: каждый читается один раз за проход
+        template <class E>
+        constexpr size_t operands = 0; // Scalar
+        template <>
+        constexpr size_t operands<Array> = 1;
+        template <>
+        constexpr size_t operands<Matrix> = 1;
+        template <class L, class R, class Operation>
+        constexpr size_t operands<Binary<L, R, Operation>> = operands<L> + operands<R>;
+    }
+    
+    void Start()
+    {
+        std::cout << "expression templates" << std::endl;
+        
+        /// Тип выражения кодирует все дерево, вычисления нет до присваивания
+        {
+            Array a{1, 2, 3}, b{4, 5, 6}, c{7, 8, 9};
+            [[maybe_unused]] auto expression = a + b * c; // Binary<Array, Binary<Array, Array, Multiply>, Add> - ни одного выделения памяти
+            Array result = expression;                     // один цикл: result[i] = a[i] + b[i] * c[i]
+            std::cout << "a + b * c = " << result[0] << " " << result[1] << " " << result[2] << std::endl; // 29 42 57
+            
+            Matrix m(2, 2, 1.0), n(2, 2, 3.0);
+            Matrix k = 2.0 * m + n * n;
+            std::cout << "2 * m + n * n = " << k(0, 0) << " " << k(1, 1) << std::endl; // 11 11
+        }
+        
+        /*
+         r = a + b * c - d * 2:
+         - eager: b * c, d * 2, a + (b * c), (...) - (d * 2) - 4 прохода, 4 новых массива (3 временных + результат), чтение 7 и запись 4 массивов;
+         - expression templates: 1 проход в уже выделенный r, чтение 4 и запись 1 массива.
+         Для массивов больше кэша время определяется трафиком памяти, для маленьких - выделениями памяти и числом проходов.
+         Трафик - расчетный: прочитанные и записанные элементы (счетчик в eager-операторах и число операндов в типе выражения), без учета кэша.
+         */
+        std::cout << std::setw(10) << "size" << std::setw(14) << "eager ms" << std::setw(16) << "expression ms"
+                  << std::setw(14) << "eager alloc" << std::setw(18) << "eager traffic MB" << std::setw(18) << "fused traffic MB" << std::endl;
+        for (size_t size : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 22})
+        {
+            const size_t repeats = std::max<size_t>(1, (size_t(1) << 24) / size);
+            
+            eager::Array ea(size, 1.0), eb(size, 2.0), ec(size, 3.0), ed(size, 4.0);
+            eager::allocations = 0;
+            const double eager_ms = benchmark::measure_ms([&]
+            {
+                for (size_t i = 0; i < repeats; ++i)
+                {
+                    eager::Array r = ea + eb * ec - ed * 2.0;
+                    benchmark::do_not_optimize(r[0]);
+                }
+            }, 3);
+            const double eager_allocations = double(eager::allocations) / double(repeats * 3);
+            
+            Array a(size, 1.0), b(size, 2.0), c(size, 3.0), d(size, 4.0), r(size);
+            const double expression_ms = benchmark::measure_ms([&]
+            {
+                for (size_t i = 0; i < repeats; ++i)
+                {
+                    r = a + b * c - d * 2.0;
+                    benchmark::do_not_optimize(r[0]);
+                }
+            }, 3);
+            
+            // Проверка: обе реализации дают одинаковый результат
+            eager::traffic = 0;
+            eager::Array check = ea + eb * ec - ed * 2.0;
+            const size_t eager_traffic = eager::traffic; // по всем операторам eager
+            const size_t fused_traffic = (operands<decltype(a + b * c - d * 2.0)> + 1) * size; // операнды + r
+            if (std::abs(check[size - 1] - r[size - 1]) > 1e-9)
+                std::cout << "ошибка: результаты не совпадают" << std::endl;
+            
+            auto megabytes = [](size_t elements) { return double(elements * sizeof(double)) / (1 << 20); };
+            std::cout << std::setw(10) << size << std::fixed << std::setprecision(3)
+                      << std::setw(14) << eager_ms / double(repeats) << std::setw(16) << expression_ms / double(repeats)
+                      << std::setprecision(1) << std::setw(14) << eager_allocations
+                      << std::setprecision(2) << std::setw(18) << megabytes(eager_traffic) << std::setw(18) << megabytes(fused_traffic) << std::endl;
+        }
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        
+        std::cout << std::endl;
+    }
+}
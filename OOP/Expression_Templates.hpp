@@ -0,0 +1,207 @@
+#ifndef Expression_Templates_hpp
+#define Expression_Templates_hpp
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+/*
+ Expression templates (шаблоны выражений) - операторы не считают результат, а возвращают легкий объект-узел дерева выражения (Binary<L, R, Op>), тип которого кодирует все выражение.
+ Вычисление происходит один раз при присваивании в Array/Matrix: один цикл по элементам, в котором для каждого i вычисляется все дерево (fusion).
+ Eager (жадная) реализация: r = a + b * c - d * 2 создает 3 временных массива (3 выделения памяти) и 4 прохода по памяти, expression templates - 0 временных и 1 проход.
+ Это продолжение темы RVO: RVO убирает копирование возвращаемого временного объекта, а expression templates - сами временные объекты.
+ Ограничения: узлы хранят ссылки на массивы, поэтому выражение можно сохранить в auto, но оно не должно пережить свои операнды (временный массив в выражении умирает в конце полного выражения); произведение матриц не поэлементное и сюда не входит.
+ */
+namespace expression_templates
+{
+    /// Форма: массив - rows x 1
+    struct Shape
+    {
+        size_t rows = 0;
+        size_t cols = 1;
+        
+        size_t size() const noexcept { return rows * cols; }
+        bool operator==(const Shape&) const = default;
+    };
+    
+    /// CRTP-база всех узлов выражения
+    template <class E>
+    struct Expression
+    {
+        const E& self() const noexcept { return static_cast<const E&>(*this); }
+        Shape shape() const noexcept { return self().shape(); }
+        double operator[](size_t index) const { return self()[index]; }
+    };
+    
+    /// Плотное хранилище: вычисляет выражение одним циклом при конструировании/присваивании
+    template <class Derived>
+    class Dense : public Expression<Derived>
+    {
+    public:
+        Shape shape() const noexcept { return _shape; }
+        size_t size() const noexcept { return _data.size(); }
+        
+        double operator[](size_t index) const noexcept { return _data[index]; }
+        double& operator[](size_t index) noexcept { return _data[index]; }
+        
+        double* data() noexcept { return _data.data(); }
+        const double* data() const noexcept { return _data.data(); }
+    
+    protected:
+        Dense() = default;
+        Dense(Shape shape, double value) : _shape(shape), _data(shape.size(), value) {}
+        
+        template <class E>
+        Dense(const Expression<E>& expression) : _shape(expression.shape()), _data(_shape.size())
+        {
+            assign(expression);
+        }
+        
+        template <class E>
+        void assign(const Expression<E>& expression)
+        {
+            if (!(expression.shape() == _shape))
+            {
+                _shape = expression.shape();
+                _data.resize(_shape.size()); // новая память только при смене формы
+            }
+            const E& source = expression.self();
+            double* data = _data.data();
+            const size_t size = _data.size();
+            for (size_t i = 0; i < size; ++i) // одно слияние всего дерева: без временных массивов, компилятор векторизует цикл
+                data[i] = source[i];
+        }
+        
+        Shape _shape;
+        std::vector<double> _data;
+    };
+    
+    class Array : public Dense<Array>
+    {
+    public:
+        Array() = default;
+        explicit Array(size_t size, double value = 0.0) : Dense({size, 1}, value) {}
+        Array(std::initializer_list<double> values) : Dense({values.size(), 1}, 0.0) { std::copy(values.begin(), values.end(), _data.begin()); }
+        
+        template <class E>
+        Array(const Expression<E>& expression) : Dense(expression) {}
+        
+        template <class E>
+        Array& operator=(const Expression<E>& expression)
+        {
+            assign(expression);
+            return *this;
+        }
+    };
+    
+    class Matrix : public Dense<Matrix>
+    {
+    public:
+        Matrix() = default;
+        Matrix(size_t rows, size_t cols, double value = 0.0) : Dense({rows, cols}, value) {}
+        
+        template <class E>
+        Matrix(const Expression<E>& expression) : Dense(expression) {}
+        
+        template <class E>
+        Matrix& operator=(const Expression<E>& expression)
+        {
+            assign(expression);
+            return *this;
+        }
+        
+        size_t rows() const noexcept { return _shape.rows; }
+        size_t cols() const noexcept { return _shape.cols; }
+        
+        double operator()(size_t row, size_t col) const noexcept { return _data[row * _shape.cols + col]; }
+        double& operator()(size_t row, size_t col) noexcept { return _data[row * _shape.cols + col]; }
+    };
+    
+    /// Скаляр в выражении: 2.0 * a
+    class Scalar : public Expression<Scalar>
+    {
+    public:
+        Scalar(double value, Shape shape) noexcept : _value(value), _shape(shape) {}
+        
+        Shape shape() const noexcept { return _shape; }
+        double operator[](size_t) const noexcept { return _value; }
+    
+    private:
+        double _value;
+        Shape _shape;
+    };
+    
+    namespace detail
+    {
+        /// Массивы хранятся в узле по ссылке (не копируются), промежуточные узлы - по значению (они живут только во временных объектах)
+        template <class E>
+        using Stored = std::conditional_t<std::is_same_v<E, Array> || std::is_same_v<E, Matrix>, const E&, E>;
+    }
+    
+    template <class L, class R, class Operation>
+    class Binary : public Expression<Binary<L, R, Operation>>
+    {
+    public:
+        Binary(const L& left, const R& right) : _left(left), _right(right)
+        {
+            assert(left.shape() == right.shape());
+        }
+        
+        Shape shape() const noexcept { return _left.shape(); }
+        double operator[](size_t index) const { return Operation::apply(_left[index], _right[index]); }
+    
+    private:
+        detail::Stored<L> _left;
+        detail::Stored<R> _right;
+    };
+    
+    struct Add { static double apply(double left, double right) noexcept { return left + right; } };
+    struct Subtract { static double apply(double left, double right) noexcept { return left - right; } };
+    struct Multiply { static double apply(double left, double right) noexcept { return left * right; } };
+    struct Divide { static double apply(double left, double right) noexcept { return left / right; } };
+    
+    template <class L, class R>
+    Binary<L, R, Add> operator+(const Expression<L>& left, const Expression<R>& right) { return {left.self(), right.self()}; }
+    template <class L, class R>
+    Binary<L, R, Subtract> operator-(const Expression<L>& left, const Expression<R>& right) { return {left.self(), right.self()}; }
+    template <class L, class R>
+    Binary<L, R, Multiply> operator*(const Expression<L>& left, const Expression<R>& right) { return {left.self(), right.self()}; }
+    template <class L, class R>
+    Binary<L, R, Divide> operator/(const Expression<L>& left, const Expression<R>& right) { return {left.self(), right.self()}; }
+    
+    template <class E>
+    Binary<Scalar, E, Multiply> operator*(double value, const Expression<E>& expression) { return {Scalar(value, expression.shape()), expression.self()}; }
+    template <class E>
+    Binary<E, Scalar, Multiply> operator*(const Expression<E>& expression, double value) { return {expression.self(), Scalar(value, expression.shape())}; }
+    template <class E>
+    Binary<E, Scalar, Add> operator+(const Expression<E>& expression, double value) { return {expression.self(), Scalar(value, expression.shape())}; }
+    
+    /// Жадная реализация для сравнения: каждый оператор возвращает новый массив (RVO убирает копию, но не сам временный массив)
+    namespace eager
+    {
+        class Array
+        {
+        public:
+            explicit Array(size_t size, double value = 0.0);
+            
+            size_t size() const noexcept { return _data.size(); }
+            double operator[](size_t index) const noexcept { return _data[index]; }
+            double& operator[](size_t index) noexcept { return _data[index]; }
+            
+            friend Array operator+(const Array& left, const Array& right);
+            friend Array operator-(const Array& left, const Array& right);
+            friend Array operator*(const Array& left, const Array& right);
+            friend Array operator*(const Array& left, double value);
+        
+        private:
+            std::vector<double> _data;
+        };
+    }
+    
+    void Start();
+}
+
+#endif /* Expression_Templates_hpp */
@@ -0,0 +1,167 @@
+#include "External_Polymorphism.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+ Сайты: https://www.dre.vanderbilt.edu/~schmidt/PDF/C++-EP.pdf
+        https://www.youtube.com/watch?v=4eeESJQk-mw
+ */
+
+namespace external_polymorphism
+{
+    namespace
+    {
+        /// Классическая иерархия из Aligment.cpp: vptr в каждом объекте
+        namespace virtual_objects
+        {
+            struct Base
+            {
+                virtual ~Base() = default;
+                virtual int function(int value) const = 0;
+            };
+            
+            struct Derived1 final : Base
+            {
+                explicit Derived1(char c) : c(c) {}
+                int function(int value) const override { return value + c; }
+                
+                char c;
+            };
+            
+            struct Derived2 final : Base
+            {
+                explicit Derived2(char c) : c(c) {}
+                int function(int value) const override { return value * 2 - c; }
+                
+                char c;
+            };
+            
+            struct Derived3 final : Base
+            {
+                Derived3(char a, char b) : a(a), b(b) {}
+                int function(int value) const override { return (value ^ a) + b; }
+                
+                char a, b;
+            };
+        }
+        
+        /// Те же данные без vptr: только поля
+        namespace compact_objects
+        {
+            struct Derived1 { char c; };
+            struct Derived2 { char c; };
+            struct Derived3 { char a, b; };
+            
+            /// Операция снаружи типов - перегрузка на каждый тип
+            struct Function
+            {
+                int operator()(const Derived1& object, int value) const { return value + object.c; }
+                int operator()(const Derived2& object, int value) const { return value * 2 - object.c; }
+                int operator()(const Derived3& object, int value) const { return (value ^ object.a) + object.b; }
+            };
+            
+            template <class Index>
+            using Object = packed<Index, Derived1, Derived2, Derived3>;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "external polymorphism" << std::endl;
+        
+        /// Размеры объектов
+        {
+            using namespace compact_objects;
+            std::cout << "sizeof(virtual Derived1): " << sizeof(virtual_objects::Derived1) << std::endl;    // 16
+            std::cout << "sizeof(packed<uint8_t>): " << sizeof(Object<std::uint8_t>) << std::endl;    // 3
+            std::cout << "sizeof(packed<uint16_t>): " << sizeof(Object<std::uint16_t>) << std::endl;  // 4
+            std::cout << "sizeof(packed<uint32_t>): " << sizeof(Object<std::uint32_t>) << std::endl;  // 8 - выравнивание по Index
+            
+            const Object<std::uint8_t> object = Derived3{1, 2};
+            std::cout << "index: " << int(object.index()) << ", function(10): " << object.visit(Function{}, 10) << std::endl; // index: 2, function(10): 13
+        }
+        
+        /*
+         2 млн объектов трех типов в случайном порядке:
+         - vector<unique_ptr<Base>>: указатель 8 байтов + объект 16 байтов в куче (+ служебные данные malloc), вызов через vptr;
+         - vector<packed<uint8_t>>: 3 байта на объект подряд, вызов через глобальную таблицу по номеру типа.
+         */
+        {
+            constexpr size_t count = 2'000'000;
+            std::mt19937 generator(5);
+            std::vector<int> kinds(count);
+            for (auto& kind : kinds)
+                kind = static_cast<int>(generator() % 3);
+            
+            std::vector<std::unique_ptr<virtual_objects::Base>> virtuals;
+            std::vector<compact_objects::Object<std::uint8_t>> compacts;
+            std::vector<compact_objects::Object<std::uint32_t>> compacts32;
+            virtuals.reserve(count);
+            compacts.reserve(count);
+            compacts32.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const char c = static_cast<char>(i % 100);
+                switch (kinds[i])
+                {
+                    case 0:
+                        virtuals.push_back(std::make_unique<virtual_objects::Derived1>(c));
+                        compacts.push_back(compact_objects::Derived1{c});
+                        compacts32.push_back(compact_objects::Derived1{c});
+                        break;
+                    case 1:
+                        virtuals.push_back(std::make_unique<virtual_objects::Derived2>(c));
+                        compacts.push_back(compact_objects::Derived2{c});
+                        compacts32.push_back(compact_objects::Derived2{c});
+                        break;
+                    default:
+                        virtuals.push_back(std::make_unique<virtual_objects::Derived3>(c, 1));
+                        compacts.push_back(compact_objects::Derived3{c, 1});
+                        compacts32.push_back(compact_objects::Derived3{c, 1});
+                        break;
+                }
+            }
+            
+            const size_t virtual_bytes = count * (sizeof(void*) + sizeof(virtual_objects::Derived1));
+            const size_t compact_bytes = count * sizeof(compact_objects::Object<std::uint8_t>);
+            const size_t compact32_bytes = count * sizeof(compact_objects::Object<std::uint32_t>);
+            std::cout << "память: virtual " << virtual_bytes / 1024 << " KiB (без служебных данных malloc), packed<uint8_t> "
+                      << compact_bytes / 1024 << " KiB, packed<uint32_t> " << compact32_bytes / 1024 << " KiB" << std::endl;
+            
+            long long virtual_sum = 0, compact_sum = 0, compact32_sum = 0;
+            const double virtual_ms = benchmark::measure_ms([&]
+            {
+                virtual_sum = 0;
+                for (const auto& object : virtuals)
+                    virtual_sum += object->function(7);
+                benchmark::do_not_optimize(virtual_sum);
+            });
+            const double compact_ms = benchmark::measure_ms([&]
+            {
+                compact_sum = 0;
+                for (const auto& object : compacts)
+                    compact_sum += object.visit(compact_objects::Function{}, 7);
+                benchmark::do_not_optimize(compact_sum);
+            });
+            const double compact32_ms = benchmark::measure_ms([&]
+            {
+                compact32_sum = 0;
+                for (const auto& object : compacts32)
+                    compact32_sum += object.visit(compact_objects::Function{}, 7);
+                benchmark::do_not_optimize(compact32_sum);
+            });
+            
+            std::cout << "суммы " << (virtual_sum == compact_sum && compact_sum == compact32_sum ? "совпадают" : "НЕ совпадают") << std::endl;
+            std::cout << "vector<unique_ptr<Base>>: " << virtual_ms << " ms" << std::endl;
+            std::cout << "vector<packed<uint8_t>>: " << compact_ms << " ms" << std::endl;
+            std::cout << "vector<packed<uint32_t>>: " << compact32_ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
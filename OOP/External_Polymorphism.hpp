@@ -0,0 +1,93 @@
+#ifndef External_Polymorphism_hpp
+#define External_Polymorphism_hpp
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ Внешний полиморфизм (external polymorphism) для крошечных объектов.
+ В Aligment.cpp Derived1 : Base хранит 1 байт данных, но занимает 16 байтов: 8 байтов vptr + int number + char c + выравнивание по 8.
+ packed<Index, Types...> хранит вместо vptr номер типа Index (uint8_t/uint16_t/uint32_t - 1-4 байта) рядом с данными, а сами типы - обычные структуры без виртуальных функций.
+ Операции задаются снаружи: Operation - функтор с перегрузками operator() для каждого типа, а вызов идет через глобальную constexpr таблицу указателей на функции table<Operation> (своя таблица на операцию, как vtable на класс).
+ Объект занимает sizeof(Index) + максимальный размер данных (с выравниванием самого строгого типа) и хранится по значению в std::vector без указателей и выделений памяти.
+ Ограничение: типы данных trivially copyable и trivially destructible - packed копируется побайтово и ничего не разрушает.
+ */
+namespace external_polymorphism
+{
+    template <class T, class... Types>
+    constexpr size_t index_of() noexcept
+    {
+        constexpr bool matches[] = {std::is_same_v<T, Types>...};
+        for (size_t i = 0; i < sizeof...(Types); ++i)
+        {
+            if (matches[i])
+                return i;
+        }
+        return sizeof...(Types);
+    }
+    
+    template <class Index, class... Types>
+    class packed
+    {
+        static_assert(std::is_unsigned_v<Index>, "Index - беззнаковый целый тип");
+        static_assert(sizeof...(Types) > 0 && sizeof...(Types) - 1 <= std::numeric_limits<Index>::max(), "номер типа не помещается в Index");
+        static_assert(((std::is_trivially_copyable_v<Types> && std::is_trivially_destructible_v<Types>) && ...), "packed хранит только trivially copyable и trivially destructible типы");
+        
+        static constexpr size_t size = std::max({sizeof(Types)...});
+        static constexpr size_t alignment = std::max({alignof(Types)...});
+    
+    public:
+        template <class T>
+        static constexpr Index index_v = static_cast<Index>(index_of<T, Types...>());
+        
+        /// Глобальная таблица операции: по номеру типа - функция, восстанавливающая тип данных
+        template <class Operation, class... Args>
+        struct table
+        {
+            using result_type = std::common_type_t<std::invoke_result_t<const Operation&, const Types&, Args...>...>;
+            using function_type = result_type (*)(const Operation&, const std::byte*, Args...);
+            
+            static constexpr std::array<function_type, sizeof...(Types)> functions =
+            {
+                [](const Operation& operation, const std::byte* data, Args... args) -> result_type
+                {
+                    return operation(*std::launder(reinterpret_cast<const Types*>(data)), std::forward<Args>(args)...);
+                }...
+            };
+        };
+        
+        template <class T>
+        packed(const T& value) noexcept requires (index_of<T, Types...>() < sizeof...(Types)) : _index(index_v<T>)
+        {
+            ::new (static_cast<void*>(_data)) T(value);
+        }
+        
+        Index index() const noexcept { return _index; }
+        
+        template <class T>
+        bool holds() const noexcept { return _index == index_v<T>; }
+        
+        template <class T>
+        const T& get() const noexcept { return *std::launder(reinterpret_cast<const T*>(_data)); }
+        
+        template <class Operation, class... Args>
+        decltype(auto) visit(const Operation& operation, Args&&... args) const
+        {
+            return table<Operation, Args&&...>::functions[_index](operation, _data, std::forward<Args>(args)...);
+        }
+    
+    private:
+        Index _index;
+        alignas(alignment) std::byte _data[size];
+    };
+    
+    void Start();
+}
+
+#endif /* External_Polymorphism_hpp */
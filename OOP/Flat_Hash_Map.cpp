@@ -0,0 +1,227 @@
+#include "Flat_Hash_Map.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+/*
+ Видео: https://www.youtube.com/watch?v=ncHmEUmJZf4&ab_channel=CppCon
+ Сайты: https://abseil.io/about/design/swisstables
+        https://habr.com/ru/articles/683136/
+ */
+
+namespace flat_hash_map
+{
+    namespace
+    {
+        /// Ключ со стандартным устройством без padding: хешируется и сравнивается побайтово
+        struct Key
+        {
+            std::uint32_t user;
+            std::uint32_t item;
+        };
+        
+        /// char + int: 3 байта padding, побайтовое сравнение невозможно
+        struct PaddedKey
+        {
+            char type;
+            std::int32_t id;
+        };
+        
+        /// Тот же хеш для std::unordered_map, чтобы сравнивались таблицы, а не хеш-функции
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const noexcept { return default_hash<Key>{}(key); }
+        };
+        
+        struct KeyEqual
+        {
+            bool operator()(const Key& lhs, const Key& rhs) const noexcept { return lhs.user == rhs.user && lhs.item == rhs.item; }
+        };
+        
+        /// Значение, конструктор которого бросает исключение для нечетных data; live - число живых объектов
+        struct ThrowingValue
+        {
+            inline static int live = 0;
+            
+            explicit ThrowingValue(int data) : data(data)
+            {
+                if (data & 1)
+                    throw std::runtime_error("odd value");
+                ++live;
+            }
+            ThrowingValue(const ThrowingValue& other) : data(other.data) { ++live; }
+            ~ThrowingValue() { --live; }
+            
+            int data;
+        };
+        
+        std::vector<Key> make_keys(size_t count, std::uint32_t seed)
+        {
+            std::mt19937 random(seed);
+            std::vector<Key> keys(count);
+            for (size_t i = 0; i < count; ++i)
+                keys[i] = Key{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(random())}; // уникальность гарантирует user
+            std::shuffle(keys.begin(), keys.end(), random);
+            return keys;
+        }
+        
+        struct Result
+        {
+            double insert = 0;
+            double hit = 0;
+            double miss = 0;
+            double erase = 0;
+        };
+        
+        template <class Map, class Insert, class Find>
+        Result run(const std::vector<Key>& keys, const std::vector<Key>& missing, Insert insert, Find find)
+        {
+            Result result;
+            const double count = static_cast<double>(keys.size());
+            const size_t repeats = keys.size() <= 100'000 ? 5 : 1;
+            
+            result.insert = benchmark::measure_ns([&]
+            {
+                Map map;
+                for (const auto& key : keys)
+                    insert(map, key);
+                benchmark::do_not_optimize(map.size());
+            }, repeats) / count;
+            
+            Map map;
+            for (const auto& key : keys)
+                insert(map, key);
+            
+            result.hit = benchmark::measure_ns([&]
+            {
+                std::uint64_t sum = 0;
+                for (const auto& key : keys)
+                    sum += find(map, key);
+                benchmark::do_not_optimize(sum);
+            }, repeats) / count;
+            
+            result.miss = benchmark::measure_ns([&]
+            {
+                std::uint64_t sum = 0;
+                for (const auto& key : missing)
+                    sum += find(map, key);
+                benchmark::do_not_optimize(sum);
+            }, repeats) / count;
+            
+            result.erase = benchmark::measure_ns([&]
+            {
+                for (const auto& key : keys)
+                    map.erase(key);
+                benchmark::do_not_optimize(map.size());
+            }, 1) / count;
+            
+            return result;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "flat hash map (swiss table), группа: " << Group::width << " байт" << std::endl;
+        
+        [[maybe_unused]] auto key_unique = std::has_unique_object_representations_v<Key>; // true: хеш и сравнение побайтово
+        [[maybe_unused]] auto padded_unique = std::has_unique_object_representations_v<PaddedKey>; // false: нужны std::hash и operator==
+        
+        /// Корректность против std::unordered_map
+        {
+            FlatHashMap<Key, std::uint64_t> map;
+            std::unordered_map<Key, std::uint64_t, KeyHash, KeyEqual> reference;
+            std::mt19937 random(1);
+            bool equal = true;
+            for (int i = 0; i < 200'000; ++i)
+            {
+                const Key key{static_cast<std::uint32_t>(random() % 5000), static_cast<std::uint32_t>(random() % 3)};
+                switch (random() % 3)
+                {
+                    case 0: map[key] = i; reference[key] = i; break;
+                    case 1: equal &= map.erase(key) == (reference.erase(key) == 1); break;
+                    default:
+                        const auto* value = map.find(key);
+                        const auto it = reference.find(key);
+                        equal &= (value == nullptr) == (it == reference.end()) && (value == nullptr || *value == it->second);
+                }
+            }
+            equal &= map.size() == reference.size();
+            std::cout << "Сравнение с std::unordered_map: " << (equal ? "OK" : "FAIL") << std::endl;
+        }
+        
+        /// Исключение из конструктора значения: ячейка не помечается занятой, размер таблицы не меняется
+        {
+            {
+                FlatHashMap<Key, ThrowingValue> map;
+                int thrown = 0;
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const Key key{static_cast<std::uint32_t>(i % 100), 0};
+                    try
+                    {
+                        map.emplace(key, i);
+                    }
+                    catch (const std::runtime_error&)
+                    {
+                        ++thrown;
+                    }
+                    if (i % 3 == 0)
+                        map.erase(key); // удаленные ячейки (tombstones) тоже переиспользуются при вставке
+                }
+                
+                bool consistent = static_cast<int>(map.size()) == ThrowingValue::live;
+                for (std::uint32_t user = 0; user < 100; ++user)
+                {
+                    const auto* value = map.find(Key{user, 0});
+                    consistent &= value == nullptr || value->data % 100 == static_cast<int>(user);
+                }
+                std::cout << "Исключение в конструкторе значения: " << thrown << " исключений, размер " << map.size() << ", "
+                          << (consistent ? "OK" : "FAIL") << std::endl;
+            }
+            std::cout << "Живых значений после уничтожения таблицы: " << ThrowingValue::live << std::endl; // 0
+        }
+        
+        /*
+         Время на одну операцию (нс). Размеры 1e3..1e6, для 1e7/1e8 увеличить max_power (нужно несколько гигабайт памяти).
+         */
+        constexpr int max_power = 6;
+        std::cout << std::setw(10) << "size" << std::setw(22) << "insert flat/std" << std::setw(22) << "hit flat/std"
+                  << std::setw(22) << "miss flat/std" << std::setw(22) << "erase flat/std" << std::endl;
+        size_t count = 1000;
+        for (int power = 3; power <= max_power; ++power, count *= 10)
+        {
+            const auto keys = make_keys(count, 42);
+            auto missing = make_keys(count, 7);
+            for (auto& key : missing)
+                key.user += static_cast<std::uint32_t>(count); // таких ключей нет в таблице
+            
+            using Flat = FlatHashMap<Key, std::uint64_t>;
+            using Std = std::unordered_map<Key, std::uint64_t, KeyHash, KeyEqual>;
+            
+            const auto flat = run<Flat>(keys, missing,
+                [](Flat& map, const Key& key) { map.insert(key, key.item); },
+                [](Flat& map, const Key& key) -> std::uint64_t { const auto* value = map.find(key); return value ? *value : 0; });
+            const auto standard = run<Std>(keys, missing,
+                [](Std& map, const Key& key) { map.emplace(key, key.item); },
+                [](Std& map, const Key& key) -> std::uint64_t { const auto it = map.find(key); return it != map.end() ? it->second : 0; });
+            
+            auto pair = [](double lhs, double rhs)
+            {
+                std::ostringstream stream;
+                stream << std::fixed << std::setprecision(1) << lhs << " / " << rhs;
+                return stream.str();
+            };
+            std::cout << std::setw(10) << count << std::setw(22) << pair(flat.insert, standard.insert) << std::setw(22) << pair(flat.hit, standard.hit)
+                      << std::setw(22) << pair(flat.miss, standard.miss) << std::setw(22) << pair(flat.erase, standard.erase) << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
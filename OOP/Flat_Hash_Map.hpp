@@ -0,0 +1,378 @@
+#ifndef Flat_Hash_Map_hpp
+#define Flat_Hash_Map_hpp
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FLAT_HASH_MAP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_MAP_SSE2
+#endif
+
+/*
+ Swiss table - хеш-таблица с открытой адресацией: ключи и значения лежат в одном плоском массиве, а рядом хранится массив управляющих байт (control bytes).
+ Управляющий байт: 0x80 - пусто, 0xFE - удалено, 0..127 - занято, младшие 7 бит хеша (h2).
+ Поиск читает сразу группу из 16 (SSE2) / 32 (AVX2) управляющих байт и одной SIMD-инструкцией сравнивает их с h2 - до сравнения самих ключей доходят только кандидаты.
+ Ключи со стандартным устройством (standard layout из POD.cpp) без байтов выравнивания (std::has_unique_object_representations) хешируются и сравниваются побайтово - пользовательские hash/operator== не нужны.
+ */
+namespace flat_hash_map
+{
+    /// Побайтовый хеш для типов с уникальным объектным представлением (нет padding - одинаковые значения имеют одинаковые байты)
+    inline std::uint64_t hash_bytes(const void* data, size_t size) noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+        while (size >= 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31;
+            bytes += 8;
+            size -= 8;
+        }
+        if (size > 0)
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes, size);
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        }
+        hash ^= hash >> 29;
+        hash *= 0x94D049BB133111EBull;
+        return hash ^ (hash >> 32);
+    }
+    
+    template <class Key>
+    struct default_hash
+    {
+        size_t operator()(const Key& key) const noexcept
+        {
+            if constexpr (std::has_unique_object_representations_v<Key>)
+                return static_cast<size_t>(hash_bytes(&key, sizeof(Key)));
+            else
+                return std::hash<Key>{}(key);
+        }
+    };
+    
+    template <class Key>
+    struct default_equal
+    {
+        bool operator()(const Key& lhs, const Key& rhs) const noexcept
+        {
+            if constexpr (std::has_unique_object_representations_v<Key>)
+                return std::memcmp(&lhs, &rhs, sizeof(Key)) == 0;
+            else
+                return lhs == rhs;
+        }
+    };
+    
+    namespace control
+    {
+        constexpr std::int8_t empty = -128;  // 0x80
+        constexpr std::int8_t deleted = -2;  // 0xFE
+    }
+    
+    /// Группа управляющих байт, обрабатываемая за одну SIMD-инструкцию. Маска: бит i - байт i группы
+    struct Group
+    {
+#if defined(FLAT_HASH_MAP_AVX2)
+        static constexpr size_t width = 32;
+        
+        explicit Group(const std::int8_t* ctrl) noexcept : _ctrl(_mm256_load_si256(reinterpret_cast<const __m256i*>(ctrl))) {}
+        
+        std::uint32_t match(std::int8_t h2) const noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), _ctrl)));
+        }
+        
+        std::uint32_t match_empty_or_deleted() const noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_ctrl)); // у пустых и удаленных установлен старший бит
+        }
+        
+        __m256i _ctrl;
+#elif defined(FLAT_HASH_MAP_SSE2)
+        static constexpr size_t width = 16;
+        
+        explicit Group(const std::int8_t* ctrl) noexcept : _ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+        
+        std::uint32_t match(std::int8_t h2) const noexcept
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+        }
+        
+        std::uint32_t match_empty_or_deleted() const noexcept
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_ctrl)); // у пустых и удаленных установлен старший бит
+        }
+        
+        __m128i _ctrl;
+#else
+        static constexpr size_t width = 8; // переносимый вариант (например, ARM): побайтовое сравнение
+        
+        explicit Group(const std::int8_t* ctrl) noexcept { std::memcpy(_ctrl, ctrl, width); }
+        
+        std::uint32_t match(std::int8_t h2) const noexcept
+        {
+            std::uint32_t mask = 0;
+            for (size_t i = 0; i < width; ++i)
+                mask |= static_cast<std::uint32_t>(_ctrl[i] == h2) << i;
+            return mask;
+        }
+        
+        std::uint32_t match_empty_or_deleted() const noexcept
+        {
+            std::uint32_t mask = 0;
+            for (size_t i = 0; i < width; ++i)
+                mask |= static_cast<std::uint32_t>(_ctrl[i] < 0) << i;
+            return mask;
+        }
+        
+        std::int8_t _ctrl[width];
+#endif
+        
+        std::uint32_t match_empty() const noexcept
+        {
+            return match(control::empty);
+        }
+    };
+    
+    template <class Key, class Value, class Hash = default_hash<Key>, class Equal = default_equal<Key>>
+    class FlatHashMap
+    {
+    public:
+        struct Slot
+        {
+            Key key;
+            Value value;
+        };
+        
+        FlatHashMap() = default;
+        
+        FlatHashMap(const FlatHashMap&) = delete;
+        FlatHashMap& operator=(const FlatHashMap&) = delete;
+        
+        ~FlatHashMap()
+        {
+            destroy();
+        }
+        
+        size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return _size == 0; }
+        size_t capacity() const noexcept { return _capacity; }
+        
+        void reserve(size_t count)
+        {
+            const size_t needed = count * 8 / 7 + 1;
+            if (needed > _capacity)
+                rehash(std::bit_ceil(std::max(needed, Group::width)));
+        }
+        
+        Value* find(const Key& key) noexcept
+        {
+            const size_t index = find_index(key, _hash(key));
+            return index != npos ? &_slots[index].value : nullptr;
+        }
+        
+        const Value* find(const Key& key) const noexcept
+        {
+            return const_cast<FlatHashMap*>(this)->find(key);
+        }
+        
+        bool contains(const Key& key) const noexcept
+        {
+            return find(key) != nullptr;
+        }
+        
+        /// Возвращает значение и признак вставки (false - ключ уже был)
+        template <class... Args>
+        std::pair<Value*, bool> emplace(const Key& key, Args&&... args)
+        {
+            const size_t hash = _hash(key);
+            size_t index = find_index(key, hash);
+            if (index != npos)
+                return {&_slots[index].value, false};
+            
+            if ((_size + _deleted + 1) * 8 > _capacity * 7)
+            {
+                // Много удаленных - пересобираем таблицу того же размера, иначе растем вдвое
+                rehash(_capacity == 0 ? Group::width : (_size * 2 < _capacity ? _capacity : _capacity * 2));
+            }
+            
+            index = find_insert_index(hash);
+            ::new (&_slots[index]) Slot{key, Value(std::forward<Args>(args)...)}; // если конструктор Value бросит исключение, таблица не изменится
+            if (_ctrl[index] == control::deleted)
+                --_deleted;
+            _ctrl[index] = h2(hash);
+            ++_size;
+            return {&_slots[index].value, true};
+        }
+        
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value).second;
+        }
+        
+        Value& operator[](const Key& key)
+        {
+            return *emplace(key).first;
+        }
+        
+        bool erase(const Key& key) noexcept
+        {
+            const size_t index = find_index(key, _hash(key));
+            if (index == npos)
+                return false;
+            
+            _slots[index].~Slot();
+            --_size;
+            /*
+             Если в группе уже есть пустой байт, группа никогда не была полностью заполнена - ни одна цепочка поиска не проходила через нее дальше, поэтому слот можно пометить пустым.
+             Иначе ставится надгробие (deleted), чтобы не оборвать чужие цепочки поиска.
+             */
+            const size_t group = index & ~(Group::width - 1);
+            if (Group(_ctrl + group).match_empty() != 0)
+            {
+                _ctrl[index] = control::empty;
+            }
+            else
+            {
+                _ctrl[index] = control::deleted;
+                ++_deleted;
+            }
+            return true;
+        }
+        
+        void clear() noexcept
+        {
+            for (size_t i = 0; i < _capacity; ++i)
+            {
+                if (_ctrl[i] >= 0)
+                    _slots[i].~Slot();
+            }
+            if (_capacity != 0)
+                std::memset(_ctrl, static_cast<unsigned char>(control::empty), _capacity);
+            _size = _deleted = 0;
+        }
+        
+        template <class Function>
+        void for_each(Function&& function)
+        {
+            for (size_t i = 0; i < _capacity; ++i)
+            {
+                if (_ctrl[i] >= 0)
+                    function(_slots[i].key, _slots[i].value);
+            }
+        }
+    
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+        
+        static std::int8_t h2(size_t hash) noexcept { return static_cast<std::int8_t>(hash & 0x7F); }
+        static size_t h1(size_t hash) noexcept { return hash >> 7; }
+        
+        /// Треугольная последовательность групп: при числе групп 2^k обходит все группы
+        size_t find_index(const Key& key, size_t hash) const noexcept
+        {
+            if (_capacity == 0)
+                return npos;
+            
+            const size_t mask = _capacity / Group::width - 1;
+            size_t group = h1(hash) & mask;
+            for (size_t step = 1;; ++step)
+            {
+                const size_t base = group * Group::width;
+                const Group ctrl(_ctrl + base);
+                for (auto bits = ctrl.match(h2(hash)); bits != 0; bits &= bits - 1)
+                {
+                    const size_t index = base + static_cast<size_t>(std::countr_zero(bits));
+                    if (_equal(_slots[index].key, key))
+                        return index;
+                }
+                if (ctrl.match_empty() != 0)
+                    return npos;
+                group = (group + step) & mask;
+            }
+        }
+        
+        size_t find_insert_index(size_t hash) const noexcept
+        {
+            const size_t mask = _capacity / Group::width - 1;
+            size_t group = h1(hash) & mask;
+            for (size_t step = 1;; ++step)
+            {
+                const size_t base = group * Group::width;
+                const auto bits = Group(_ctrl + base).match_empty_or_deleted();
+                if (bits != 0)
+                    return base + static_cast<size_t>(std::countr_zero(bits));
+                group = (group + step) & mask;
+            }
+        }
+        
+        void rehash(size_t capacity)
+        {
+            std::int8_t* old_ctrl = _ctrl;
+            Slot* old_slots = _slots;
+            const size_t old_capacity = _capacity;
+            
+            _ctrl = static_cast<std::int8_t*>(::operator new(capacity, std::align_val_t{Group::width}));
+            std::memset(_ctrl, static_cast<unsigned char>(control::empty), capacity);
+            _slots = std::allocator<Slot>().allocate(capacity);
+            _capacity = capacity;
+            _deleted = 0;
+            
+            for (size_t i = 0; i < old_capacity; ++i)
+            {
+                if (old_ctrl[i] >= 0)
+                {
+                    const size_t hash = _hash(old_slots[i].key);
+                    const size_t index = find_insert_index(hash);
+                    ::new (&_slots[index]) Slot(std::move(old_slots[i]));
+                    _ctrl[index] = h2(hash);
+                    old_slots[i].~Slot();
+                }
+            }
+            
+            if (old_ctrl != nullptr)
+            {
+                ::operator delete(old_ctrl, std::align_val_t{Group::width});
+                std::allocator<Slot>().deallocate(old_slots, old_capacity);
+            }
+        }
+        
+        void destroy() noexcept
+        {
+            if (_ctrl == nullptr)
+                return;
+            clear();
+            ::operator delete(_ctrl, std::align_val_t{Group::width});
+            std::allocator<Slot>().deallocate(_slots, _capacity);
+            _ctrl = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+        }
+        
+        std::int8_t* _ctrl = nullptr;
+        Slot* _slots = nullptr;
+        size_t _capacity = 0;
+        size_t _size = 0;
+        size_t _deleted = 0;
+        [[no_unique_address]] Hash _hash;
+        [[no_unique_address]] Equal _equal;
+    };
+    
+    void Start();
+}
+
+#endif /* Flat_Hash_Map_hpp */
@@ -0,0 +1,249 @@
+#include "Generator.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+/*
+ Сайты: https://en.cppreference.com/w/cpp/language/coroutines
+        https://lewissbaker.github.io/2020/05/11/understanding_symmetric_transfer
+        https://habr.com/ru/articles/519464/
+ */
+
+namespace coroutine_generator
+{
+    namespace detail
+    {
+        namespace
+        {
+            constexpr size_t granularity = 64;
+            constexpr size_t classes = 32; // кадры до 2 KiB, большие - напрямую через operator new
+            
+            struct Node
+            {
+                Node* next;
+            };
+            
+            /// Свободные кадры потока: освобождаются при завершении потока
+            struct FreeLists
+            {
+                ~FreeLists()
+                {
+                    for (Node* head : heads)
+                    {
+                        while (head)
+                            ::operator delete(std::exchange(head, head->next));
+                    }
+                }
+                
+                Node* heads[classes] = {};
+            };
+            
+            thread_local FreeLists free_lists;
+            
+            size_t size_class(size_t size) noexcept
+            {
+                return (size + granularity - 1) / granularity;
+            }
+        }
+        
+        void* FrameAllocator::allocate(size_t size)
+        {
+            const size_t index = size_class(size);
+            if (index < classes)
+            {
+                if (Node* node = free_lists.heads[index])
+                {
+                    free_lists.heads[index] = node->next;
+                    return node;
+                }
+                return ::operator new(index * granularity);
+            }
+            return ::operator new(size);
+        }
+        
+        void FrameAllocator::deallocate(void* pointer, size_t size) noexcept
+        {
+            const size_t index = size_class(size);
+            if (index < classes)
+            {
+                // Кадр возвращается в список текущего потока, даже если выделен в другом
+                free_lists.heads[index] = ::new (pointer) Node{free_lists.heads[index]};
+                return;
+            }
+            ::operator delete(pointer);
+        }
+    }
+    
+    namespace
+    {
+        /// Большой объект, как A из RVO&NRVO.cpp, но с данными; live/peak - сколько объектов живет одновременно
+        struct Record
+        {
+            explicit Record(int id) : id(id), values(64, id) { peak = std::max(peak, ++live); }
+            Record(Record&& other) noexcept : id(other.id), values(std::move(other.values)) { peak = std::max(peak, ++live); }
+            Record(const Record& other) : id(other.id), values(other.values) { peak = std::max(peak, ++live); }
+            ~Record() { --live; }
+            
+            int id;
+            std::vector<int> values;
+            
+            static inline size_t live = 0;
+            static inline size_t peak = 0;
+        };
+        
+        /// Фабрика как RVO::function()
+        Record make_record(int id)
+        {
+            return Record(id);
+        }
+        
+        std::vector<Record> eager_records(int count)
+        {
+            std::vector<Record> records;
+            records.reserve(static_cast<size_t>(count));
+            for (int i = 0; i < count; ++i)
+                records.push_back(make_record(i));
+            return records;
+        }
+        
+        generator<Record> lazy_records(int count)
+        {
+            for (int i = 0; i < count; ++i)
+                co_yield make_record(i);
+        }
+        
+        generator<int> range(int first, int last)
+        {
+            for (int i = first; i < last; ++i)
+                co_yield i;
+        }
+        
+        /// Обход дерева: каждый уровень - вложенный генератор
+        generator<int> tree(int depth, int value)
+        {
+            if (depth == 0)
+            {
+                co_yield value;
+                co_return;
+            }
+            co_yield elements_of(tree(depth - 1, value * 2));
+            co_yield elements_of(tree(depth - 1, value * 2 + 1));
+        }
+        
+        generator<int> failing()
+        {
+            co_yield 1;
+            throw std::runtime_error("ошибка в генераторе");
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "generator" << std::endl;
+        
+        /// 1 Пример: простой генератор
+        {
+            std::cout << "range: ";
+            for (int number : range(0, 5))
+                std::cout << number << " "; // 0 1 2 3 4
+            std::cout << std::endl;
+        }
+        /// 2 Пример: вложенные генераторы (co_yield elements_of)
+        {
+            std::cout << "листья дерева глубины 3: ";
+            for (int leaf : tree(3, 1))
+                std::cout << leaf << " "; // 8 9 10 11 12 13 14 15
+            std::cout << std::endl;
+            
+            // Глубина 20 - миллион листьев, одновременно живет 21 кадр, а стек не растет благодаря symmetric transfer
+            long long sum = 0;
+            for (int leaf : tree(20, 1))
+                sum += leaf;
+            std::cout << "сумма листьев дерева глубины 20: " << sum << std::endl;
+        }
+        /// 3 Пример: исключение из генератора выходит из итератора
+        {
+            try
+            {
+                for (int number : failing())
+                    std::cout << "получено: " << number << std::endl;
+            }
+            catch (const std::runtime_error& exception)
+            {
+                std::cout << "исключение: " << exception.what() << std::endl;
+            }
+        }
+        
+        /*
+         Потребитель один раз перебирает объекты фабрики:
+         - vector: все объекты строятся заранее - пиковая память N объектов, первый элемент - после построения последнего;
+         - generator: в памяти один объект, первый элемент - сразу.
+         */
+        {
+            constexpr int count = 50'000;
+            const size_t record_bytes = sizeof(Record) + 64 * sizeof(int);
+            
+            Record::peak = Record::live = 0;
+            benchmark::Timer eager_timer;
+            double eager_first_ms = 0;
+            long long eager_sum = 0;
+            {
+                bool first = true;
+                for (const Record& record : eager_records(count))
+                {
+                    if (first)
+                    {
+                        eager_first_ms = eager_timer.elapsed_ms();
+                        first = false;
+                    }
+                    eager_sum += record.values.back();
+                }
+            }
+            const double eager_ms = eager_timer.elapsed_ms();
+            const size_t eager_peak = Record::peak;
+            
+            Record::peak = Record::live = 0;
+            benchmark::Timer lazy_timer;
+            double lazy_first_ms = 0;
+            long long lazy_sum = 0;
+            {
+                bool first = true;
+                for (const Record& record : lazy_records(count))
+                {
+                    if (first)
+                    {
+                        lazy_first_ms = lazy_timer.elapsed_ms();
+                        first = false;
+                    }
+                    lazy_sum += record.values.back();
+                }
+            }
+            const double lazy_ms = lazy_timer.elapsed_ms();
+            const size_t lazy_peak = Record::peak;
+            
+            std::cout << count << " объектов, сумма " << (eager_sum == lazy_sum ? "совпадает" : "НЕ совпадает") << std::endl;
+            std::cout << "vector: первый элемент " << eager_first_ms << " ms, всего " << eager_ms << " ms, пик " << eager_peak << " объектов (" << eager_peak * record_bytes << " B)" << std::endl;
+            std::cout << "generator: первый элемент " << lazy_first_ms << " ms, всего " << lazy_ms << " ms, пик " << lazy_peak << " объектов (" << lazy_peak * record_bytes << " B)" << std::endl;
+        }
+        
+        /// Создание генератора: кадр берется из списка свободных блоков, а не из malloc
+        {
+            constexpr int count = 100'000;
+            const double ms = benchmark::measure_ms([]
+            {
+                long long sum = 0;
+                for (int i = 0; i < count; ++i)
+                    for (int number : range(i, i + 1))
+                        sum += number;
+                benchmark::do_not_optimize(sum);
+            }, 3);
+            std::cout << "создание и перебор " << count << " генераторов: " << ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
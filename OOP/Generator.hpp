@@ -0,0 +1,211 @@
+#ifndef Generator_hpp
+#define Generator_hpp
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/*
+ generator<T> - ленивая последовательность на корутинах C++20: производитель отдает объекты по одному через co_yield, потребитель перебирает их в for, а промежуточный контейнер (std::vector на тысячи объектов) не создается.
+ В памяти одновременно живет один объект, первый элемент доступен сразу, а не после построения всего вектора.
+ - co_yield value - значение не копируется: итератор возвращает ссылку на объект, который живет в кадре корутины до следующего шага;
+ - co_yield elements_of(other()) - вложенный генератор. Потребитель продолжает сразу самый вложенный (leaf) генератор, а вход/выход из вложенного - симметричная передача управления (symmetric transfer: await_suspend возвращает coroutine_handle), поэтому стек не растет при любой глубине вложенности;
+ - кадры корутин выделяются из списков свободных блоков (free list) потока: после прогрева создание генератора не обращается к malloc.
+ */
+namespace coroutine_generator
+{
+    namespace detail
+    {
+        /// Списки свободных кадров корутин по классам размера (кратно 64 байтам), свои у каждого потока
+        class FrameAllocator
+        {
+        public:
+            static void* allocate(size_t size);
+            static void deallocate(void* pointer, size_t size) noexcept;
+        };
+    }
+    
+    template <class T>
+    class generator;
+    
+    /// co_yield elements_of(nested) - отдать все элементы вложенного генератора
+    template <class T>
+    struct elements_of
+    {
+        explicit elements_of(generator<T>&& nested) noexcept : nested(std::move(nested)) {}
+        
+        generator<T> nested;
+    };
+    
+    template <class T>
+    elements_of(generator<T>&&) -> elements_of<T>;
+    
+    template <class T>
+    class generator
+    {
+    public:
+        class promise_type;
+        using handle = std::coroutine_handle<promise_type>;
+        
+        class promise_type
+        {
+        public:
+            generator get_return_object() noexcept { return generator(handle::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            
+            /// Вложенный генератор закончился - симметричная передача управления родителю
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                
+                std::coroutine_handle<> await_suspend(handle current) noexcept
+                {
+                    promise_type& promise = current.promise();
+                    if (promise._parent)
+                    {
+                        promise._root->_leaf = promise._parent;
+                        return handle::from_promise(*promise._parent);
+                    }
+                    return std::noop_coroutine();
+                }
+                
+                void await_resume() noexcept {}
+            };
+            
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            
+            std::suspend_always yield_value(const T& value) noexcept
+            {
+                _root->_value = std::addressof(value);
+                return {};
+            }
+            
+            std::suspend_always yield_value(T&& value) noexcept
+            {
+                _root->_value = std::addressof(value); // временный объект живет до возобновления корутины
+                return {};
+            }
+            
+            /// Вход во вложенный генератор - симметричная передача управления ему
+            struct NestedAwaiter
+            {
+                bool await_ready() noexcept { return !nested._handle; }
+                
+                handle await_suspend(handle current) noexcept
+                {
+                    promise_type& inner = nested._handle.promise();
+                    promise_type& root = *current.promise()._root;
+                    inner._root = &root;
+                    inner._parent = &current.promise();
+                    root._leaf = &inner;
+                    return nested._handle;
+                }
+                
+                void await_resume()
+                {
+                    if (nested._handle && nested._handle.promise()._exception)
+                        std::rethrow_exception(nested._handle.promise()._exception);
+                }
+                
+                generator nested;
+            };
+            
+            NestedAwaiter yield_value(elements_of<T> elements) noexcept
+            {
+                return NestedAwaiter{std::move(elements.nested)};
+            }
+            
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { _exception = std::current_exception(); }
+            
+            /// co_await внутри генератора запрещен
+            template <class U>
+            std::suspend_never await_transform(U&&) = delete;
+            
+            static void* operator new(size_t size) { return detail::FrameAllocator::allocate(size); }
+            static void operator delete(void* pointer, size_t size) noexcept { detail::FrameAllocator::deallocate(pointer, size); }
+        
+        private:
+            friend generator;
+            
+            promise_type* _root = this;
+            promise_type* _parent = nullptr;
+            promise_type* _leaf = this;   // только у корня: самый вложенный активный генератор
+            const T* _value = nullptr;    // только у корня: текущий элемент
+            std::exception_ptr _exception;
+        };
+        
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = const T&;
+            using pointer = const T*;
+            
+            iterator() noexcept = default;
+            explicit iterator(handle root) noexcept : _root(root) {}
+            
+            reference operator*() const noexcept { return *_root.promise()._value; }
+            pointer operator->() const noexcept { return _root.promise()._value; }
+            
+            iterator& operator++()
+            {
+                handle::from_promise(*_root.promise()._leaf).resume();
+                if (_root.promise()._exception)
+                    std::rethrow_exception(std::exchange(_root.promise()._exception, nullptr));
+                return *this;
+            }
+            
+            void operator++(int) { ++*this; }
+            
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept { return !it._root || it._root.done(); }
+        
+        private:
+            handle _root;
+        };
+        
+        generator() noexcept = default;
+        generator(generator&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+        
+        generator& operator=(generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (_handle)
+                    _handle.destroy();
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+        
+        ~generator()
+        {
+            if (_handle)
+                _handle.destroy(); // вложенные генераторы лежат в кадре и разрушаются вместе с ним
+        }
+        
+        iterator begin()
+        {
+            iterator it(_handle);
+            if (_handle)
+                ++it;
+            return it;
+        }
+        
+        std::default_sentinel_t end() const noexcept { return {}; }
+    
+    private:
+        explicit generator(handle coroutine) noexcept : _handle(coroutine) {}
+        
+        handle _handle;
+    };
+    
+    void Start();
+}
+
+#endif /* Generator_hpp */
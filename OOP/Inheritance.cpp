@@ -1,4 +1,5 @@
 #include "Inheritance.hpp"
+#include "Noexcept_Audit.hpp"
 
 #include <iostream>
 
@@ -327,6 +328,26 @@ namespace no_virtual_destructor_inheritance
     };
 }
 
+/// Аудит noexcept перемещения (Noexcept_Audit.hpp): типы попадают в общий отчет
+NOEXCEPT_AUDIT(public_inheritance::A);
+NOEXCEPT_AUDIT(public_inheritance::B);
+NOEXCEPT_AUDIT(public_inheritance::C);
+NOEXCEPT_AUDIT(protected_inheritance::Base);
+NOEXCEPT_AUDIT(protected_inheritance::Derived);
+NOEXCEPT_AUDIT(protected_inheritance::PublicDerived);
+NOEXCEPT_AUDIT(protected_inheritance::ProtectedDerived);
+NOEXCEPT_AUDIT(protected_inheritance::PrivateDerived);
+NOEXCEPT_AUDIT(private_inheritance::Base);
+NOEXCEPT_AUDIT(private_inheritance::Derived);
+NOEXCEPT_AUDIT(private_inheritance::DerivedDerived);
+NOEXCEPT_AUDIT(diamond_inheritance::A);
+NOEXCEPT_AUDIT(diamond_inheritance::B);
+NOEXCEPT_AUDIT(diamond_inheritance::C);
+NOEXCEPT_AUDIT(diamond_inheritance::D);
+NOEXCEPT_AUDIT(no_virtual_destructor_inheritance::A);
+NOEXCEPT_AUDIT(no_virtual_destructor_inheritance::B);
+NOEXCEPT_AUDIT(no_virtual_destructor_inheritance::C);
+
 namespace inheritance
 {
     void Start()
@@ -1,6 +1,8 @@
 #include "Initialization.hpp"
+#include "Noexcept_Audit.hpp"
 
 #include <iostream>
+#include <memory>
 
 
 namespace initialization_order
@@ -191,6 +193,20 @@ namespace Order_Capital
     };
 }
 
+/// Аудит noexcept перемещения (Noexcept_Audit.hpp): типы попадают в общий отчет
+NOEXCEPT_AUDIT(initialization_order::A);
+NOEXCEPT_AUDIT(initialization_order::B);
+NOEXCEPT_AUDIT(initialization_order::C);
+NOEXCEPT_AUDIT(initialization_order::D);
+NOEXCEPT_AUDIT(initialization_order::E);
+NOEXCEPT_AUDIT(exception::A);
+NOEXCEPT_AUDIT(exception::B);
+NOEXCEPT_AUDIT(exception::C);
+NOEXCEPT_AUDIT(exception::D);
+NOEXCEPT_AUDIT(exception::E);
+NOEXCEPT_AUDIT(Order_Capital::A);
+NOEXCEPT_AUDIT(Order_Capital::B);
+
 namespace initialization
 {
     void Start()
@@ -0,0 +1,115 @@
+#include "Inline_Cache.hpp"
+#include "Benchmark.hpp"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+ Сайты: https://en.wikipedia.org/wiki/Inline_caching
+        https://mrale.ph/blog/2012/06/03/explaining-js-vms-in-js-inline-caches.html
+ */
+
+namespace inline_cache
+{
+    namespace
+    {
+        constexpr size_t max_types = 8;
+        
+        struct Base
+        {
+            explicit Base(int data) : data(data) {}
+            virtual ~Base() = default;
+            virtual int print(int number) const = 0;
+            
+            int data;
+        };
+        
+        template <int K>
+        struct Derived final : Base
+        {
+            using Base::Base;
+            int print(int number) const override { return number * (K + 1) + data; }
+        };
+        
+        template <size_t... K>
+        cached_dispatch<const Base, Derived<K>...> make_cache(std::index_sequence<K...>);
+        
+        using Cache = decltype(make_cache(std::make_index_sequence<max_types>{}));
+        
+        template <size_t... K>
+        std::unique_ptr<Base> make_object(size_t type, int data, std::index_sequence<K...>)
+        {
+            std::unique_ptr<Base> result;
+            (void)((type == K ? (result = std::make_unique<Derived<K>>(data), true) : false) || ...);
+            return result;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "inline cache" << std::endl;
+        
+        /// Кэш места вызова
+        {
+            Cache cache;
+            const Derived<2> derived(1);
+            const Base& base = derived;
+            auto print = [](const auto& object) { return object.print(10); }; // для Derived<K>& вызов прямой
+            std::cout << cache(base, print) << " " << cache(base, print) << ", промахов: " << cache.misses() << std::endl; // 31 31, промахов: 1
+        }
+        
+        /*
+         Степень полиморфизма места вызова: 1 тип, 2 типа по очереди, 2/4/8 типов в случайном порядке (1 млн вызовов).
+         При 1 типе кэш всегда попадает и вызов встраивается; при случайных типах почти каждый вызов - промах: кэш проигрывает обычному виртуальному вызову.
+         */
+        {
+            constexpr size_t count = 1'000'000;
+            struct Case
+            {
+                const char* name;
+                size_t types;
+                bool random;
+            };
+            
+            for (const Case& test : {Case{"1 тип", 1, false}, Case{"2 по очереди", 2, false}, Case{"2 случайно", 2, true},
+                                     Case{"4 случайно", 4, true}, Case{"8 случайно", 8, true}})
+            {
+                std::mt19937 generator(17);
+                std::vector<std::unique_ptr<Base>> objects;
+                objects.reserve(count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const size_t type = test.random ? generator() % test.types : i % test.types;
+                    objects.push_back(make_object(type, static_cast<int>(i % 1000), std::make_index_sequence<max_types>{}));
+                }
+                
+                long long virtual_sum = 0, cached_sum = 0;
+                size_t misses = 0;
+                const double virtual_ms = benchmark::measure_ms([&]
+                {
+                    virtual_sum = 0;
+                    for (const auto& object : objects)
+                        virtual_sum += object->print(7);
+                    benchmark::do_not_optimize(virtual_sum);
+                });
+                const double cached_ms = benchmark::measure_ms([&]
+                {
+                    Cache cache;
+                    cached_sum = 0;
+                    for (const auto& object : objects)
+                        cached_sum += cache(*object, [](const auto& derived) { return derived.print(7); });
+                    benchmark::do_not_optimize(cached_sum);
+                    misses = cache.misses();
+                });
+                
+                std::cout << test.name << ": virtual " << virtual_ms << " ms, cached_dispatch " << cached_ms << " ms, промахов " << misses
+                          << (virtual_sum == cached_sum ? "" : " (суммы НЕ совпадают)") << std::endl;
+            }
+        }
+        
+        std::cout << std::endl;
+    }
+}
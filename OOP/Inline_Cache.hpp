@@ -0,0 +1,75 @@
+#ifndef Inline_Cache_hpp
+#define Inline_Cache_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+
+/*
+ Встроенный кэш (inline cache) вызова - прием JIT-компиляторов (Smalltalk, V8, HotSpot) для мест вызова, которые во время работы видят один и тот же тип.
+ cached_dispatch<Base, Candidates...> - кэш одного места вызова: запоминает последний увиденный тип (typeid) и номер подходящего кандидата.
+ - попадание: сравнение typeid с запомненным + хорошо предсказуемые условные переходы по номеру, затем прямой вызов function(Candidate&) - у final кандидата метод встраивается;
+ - промах: поиск типа среди Candidates и обновление кэша; тип не из списка вызывается через Base& (обычный виртуальный вызов).
+ Помогает мономорфным местам вызова, мешает полиморфным: при частой смене типа каждый вызов платит за промах кэша поверх обычной работы.
+ typeid переносим, в отличие от чтения vptr (первое слово объекта только в Itanium ABI и MSVC при одиночном наследовании), но стоит 2 загрузки: vptr и type_info из vtable.
+ Кэш не потокобезопасен: тип и номер меняются вместе, поэтому у каждого потока свой кэш (thread_local или член объекта).
+ */
+namespace inline_cache
+{
+    template <class Base, class... Candidates>
+    class cached_dispatch
+    {
+        static_assert(((std::is_base_of_v<std::remove_const_t<Base>, Candidates> && std::is_polymorphic_v<Candidates>) && ...), "кандидаты - полиморфные наследники Base");
+        
+        static constexpr std::uint8_t fallback = sizeof...(Candidates);
+        
+        template <size_t I>
+        using candidate = std::conditional_t<std::is_const_v<Base>, const std::tuple_element_t<I, std::tuple<Candidates...>>, std::tuple_element_t<I, std::tuple<Candidates...>>>;
+    
+    public:
+        /// function(Candidate&) для известного типа, иначе function(Base&)
+        template <class Function>
+        decltype(auto) operator()(Base& base, Function&& function)
+        {
+            const std::type_info& type = typeid(base);
+            if (&type != _type) [[unlikely]]
+                update(type);
+            return call<0>(base, function);
+        }
+        
+        size_t misses() const noexcept { return _misses; }
+    
+    private:
+        void update(const std::type_info& type) noexcept
+        {
+            ++_misses;
+            _type = &type;
+            _index = fallback;
+            std::uint8_t index = 0;
+            (void)((type == typeid(Candidates) ? (_index = index, true) : (++index, false)) || ...);
+        }
+        
+        template <size_t I, class Function>
+        decltype(auto) call(Base& base, Function& function)
+        {
+            if constexpr (I == sizeof...(Candidates))
+                return function(base); // виртуальный вызов
+            else
+            {
+                if (_index == I)
+                    return function(static_cast<candidate<I>&>(base)); // прямой вызов
+                return call<I + 1>(base, function);
+            }
+        }
+        
+        const std::type_info* _type = nullptr;
+        std::uint8_t _index = fallback;
+        size_t _misses = 0;
+    };
+    
+    void Start();
+}
+
+#endif /* Inline_Cache_hpp */
@@ -0,0 +1,151 @@
+#include "Intrusive_Ptr.hpp"
+#include "Benchmark.hpp"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+ Сайты: https://www.boost.org/doc/libs/release/libs/smart_ptr/doc/html/smart_ptr.html#intrusive_ptr
+        https://habr.com/ru/articles/191018/
+ */
+
+namespace intrusive_ptr
+{
+    namespace
+    {
+        /// C : A, B из Virtual.cpp, но со счетчиком ссылок: одна виртуальная база ref_counted на весь объект
+        namespace multiple_inheritance
+        {
+            inline size_t destroyed = 0;
+            
+            struct A : virtual ref_counted<>
+            {
+                int a = 1;
+                ~A() override { ++destroyed; }
+            };
+            
+            struct B : virtual ref_counted<>
+            {
+                int b = 2;
+                ~B() override { ++destroyed; }
+            };
+            
+            struct C : A, B
+            {
+                int c = 3;
+                ~C() override { ++destroyed; }
+            };
+        }
+        
+        struct Object
+        {
+            explicit Object(int data) : data(data) {}
+            virtual ~Object() = default;
+            
+            int data;
+        };
+        
+        template <class Policy>
+        struct Intrusive final : Object, ref_counted<Policy>
+        {
+            using Object::Object;
+        };
+        
+        /// threads потоков копируют и уничтожают указатели на одни и те же объекты (общие счетчики): время на копию
+        template <class Pointer>
+        double copy_destroy_ns(const std::vector<Pointer>& objects, size_t threads, size_t rounds)
+        {
+            std::vector<long long> sums(threads);
+            const double ns = benchmark::measure_ns([&]
+            {
+                std::vector<std::thread> workers;
+                for (size_t thread = 0; thread < threads; ++thread)
+                {
+                    workers.emplace_back([&objects, &sums, thread, rounds]
+                    {
+                        long long sum = 0;
+                        for (size_t round = 0; round < rounds; ++round)
+                        {
+                            for (const Pointer& object : objects)
+                            {
+                                const Pointer copy = object; // инкремент
+                                sum += copy->data;           // чтение объекта
+                            }                                // декремент
+                        }
+                        sums[thread] = sum;
+                    });
+                }
+                for (auto& worker : workers)
+                    worker.join();
+            }, 3);
+            benchmark::do_not_optimize(sums);
+            return ns / double(threads * rounds * objects.size());
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "intrusive ptr" << std::endl;
+        
+        /// Множественное наследование: указатель на вторую базу сдвинут, но счетчик один и удаляется весь C
+        {
+            using namespace multiple_inheritance;
+            intrusive_ptr<C> c = make_intrusive<C>();
+            intrusive_ptr<B> b = c;
+            intrusive_ptr<A> a = c;
+            std::cout << "C: " << c.get() << ", A: " << a.get() << ", B: " << b.get() << ", use_count: " << c->use_count() << std::endl; // адрес B больше адреса C, use_count: 3
+            c.reset();
+            a.reset();
+            std::cout << "destructors: " << destroyed << std::endl; // 0
+            b.reset(); // последняя ссылка через B: ~C, ~B, ~A
+            std::cout << "destructors: " << destroyed << std::endl; // 3
+        }
+        
+        /// Размеры
+        {
+            std::cout << "sizeof(shared_ptr<Object>): " << sizeof(std::shared_ptr<Object>)
+                      << ", sizeof(intrusive_ptr<Intrusive>): " << sizeof(intrusive_ptr<Intrusive<relaxed_policy>>) << std::endl; // 16, 8
+        }
+        
+        /*
+         Копия + чтение + уничтожение указателя на один из 1024 общих объектов, 1/2/4 потока:
+         - shared_ptr(new T): блок управления отдельно от объекта - 2 кэш-линии на копию;
+         - make_shared: блок управления рядом с объектом;
+         - intrusive_ptr: счетчик в объекте, указатель в 2 раза меньше.
+         С несколькими потоками время определяется борьбой за кэш-линии общих счетчиков (cache line ping-pong).
+         */
+        {
+            constexpr size_t count = 1024;
+            constexpr size_t rounds = 200;
+            
+            std::vector<std::shared_ptr<Object>> shared_new, shared_make;
+            std::vector<intrusive_ptr<Intrusive<relaxed_policy>>> relaxed;
+            std::vector<intrusive_ptr<Intrusive<atomic_policy>>> atomic;
+            std::vector<intrusive_ptr<Intrusive<single_thread_policy>>> single_thread;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const int data = static_cast<int>(i);
+                shared_new.emplace_back(new Object(data));
+                shared_make.push_back(std::make_shared<Object>(data));
+                relaxed.push_back(make_intrusive<Intrusive<relaxed_policy>>(data));
+                atomic.push_back(make_intrusive<Intrusive<atomic_policy>>(data));
+                single_thread.push_back(make_intrusive<Intrusive<single_thread_policy>>(data));
+            }
+            
+            for (const size_t threads : {size_t(1), size_t(2), size_t(4)})
+            {
+                std::cout << "потоков: " << threads << std::endl;
+                std::cout << "  shared_ptr(new): " << copy_destroy_ns(shared_new, threads, rounds) << " ns" << std::endl;
+                std::cout << "  make_shared: " << copy_destroy_ns(shared_make, threads, rounds) << " ns" << std::endl;
+                std::cout << "  intrusive_ptr, relaxed: " << copy_destroy_ns(relaxed, threads, rounds) << " ns" << std::endl;
+                std::cout << "  intrusive_ptr, atomic: " << copy_destroy_ns(atomic, threads, rounds) << " ns" << std::endl;
+                if (threads == 1) // счетчик без атомарных операций нельзя делить между потоками
+                    std::cout << "  intrusive_ptr, single thread: " << copy_destroy_ns(single_thread, threads, rounds) << " ns" << std::endl;
+            }
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef Intrusive_Ptr_hpp
+#define Intrusive_Ptr_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/*
+ Интрузивный подсчет ссылок: счетчик лежит в самом объекте (ref_counted), а intrusive_ptr<T> - один указатель.
+ std::shared_ptr<Base> хранит 2 указателя, а счетчики - в отдельном блоке управления (control block): копия трогает 2 кэш-линии (блок + объект), а shared_ptr(new T) - еще и 2 выделения памяти.
+ Политики счетчика:
+ - relaxed_policy (по умолчанию): инкремент relaxed, декремент acq_rel - минимальный корректный порядок, как в std::shared_ptr;
+ - atomic_policy: все операции seq_cst (на x86 тот же lock xadd, на ARM - лишние барьеры);
+ - single_thread_policy: обычный счетчик без атомарных операций - все копии должны жить в одном потоке.
+ Множественное наследование (C : A, B из Virtual.cpp): счетчик должен быть один на объект, поэтому A и B наследуют ref_counted виртуально.
+ intrusive_ptr<B> указывает на подобъект B внутри C (адрес сдвинут), intrusive_ptr_release находит счетчик через виртуальную базу, а виртуальный деструктор ref_counted удаляет весь объект C.
+ Для одиночного наследования виртуальное наследование не нужно.
+ */
+namespace intrusive_ptr
+{
+    struct relaxed_policy
+    {
+        using counter = std::atomic<size_t>;
+        
+        static void increment(counter& references) noexcept { references.fetch_add(1, std::memory_order_relaxed); }
+        /// true - ссылка была последней
+        static bool decrement(counter& references) noexcept { return references.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+        static size_t load(const counter& references) noexcept { return references.load(std::memory_order_relaxed); }
+    };
+    
+    struct atomic_policy
+    {
+        using counter = std::atomic<size_t>;
+        
+        static void increment(counter& references) noexcept { references.fetch_add(1); }
+        static bool decrement(counter& references) noexcept { return references.fetch_sub(1) == 1; }
+        static size_t load(const counter& references) noexcept { return references.load(); }
+    };
+    
+    struct single_thread_policy
+    {
+        using counter = size_t;
+        
+        static void increment(counter& references) noexcept { ++references; }
+        static bool decrement(counter& references) noexcept { return --references == 0; }
+        static size_t load(const counter& references) noexcept { return references; }
+    };
+    
+    /// Примесь (mixin) со счетчиком ссылок: копия объекта получает свой счетчик с нуля
+    template <class Policy = relaxed_policy>
+    class ref_counted
+    {
+    public:
+        size_t use_count() const noexcept { return Policy::load(_references); }
+        
+        friend void intrusive_ptr_add_ref(const ref_counted* object) noexcept
+        {
+            Policy::increment(object->_references);
+        }
+        
+        friend void intrusive_ptr_release(const ref_counted* object) noexcept
+        {
+            if (Policy::decrement(object->_references))
+                delete object; // виртуальный деструктор: удаляется весь объект, даже через указатель на вторую базу
+        }
+    
+    protected:
+        ref_counted() noexcept = default;
+        ref_counted(const ref_counted&) noexcept {}
+        ref_counted& operator=(const ref_counted&) noexcept { return *this; }
+        virtual ~ref_counted() = default;
+    
+    private:
+        mutable typename Policy::counter _references{0};
+    };
+    
+    template <class T>
+    class intrusive_ptr
+    {
+    public:
+        using element_type = T;
+        
+        intrusive_ptr() noexcept = default;
+        intrusive_ptr(std::nullptr_t) noexcept {}
+        
+        explicit intrusive_ptr(T* pointer) noexcept : _pointer(pointer)
+        {
+            if (_pointer)
+                intrusive_ptr_add_ref(_pointer);
+        }
+        
+        intrusive_ptr(const intrusive_ptr& other) noexcept : intrusive_ptr(other._pointer) {}
+        intrusive_ptr(intrusive_ptr&& other) noexcept : _pointer(std::exchange(other._pointer, nullptr)) {}
+        
+        /// intrusive_ptr<Derived> -> intrusive_ptr<Base>: при множественном наследовании адрес сдвигается на подобъект Base
+        template <class U> requires std::is_convertible_v<U*, T*>
+        intrusive_ptr(const intrusive_ptr<U>& other) noexcept : intrusive_ptr(other.get()) {}
+        
+        template <class U> requires std::is_convertible_v<U*, T*>
+        intrusive_ptr(intrusive_ptr<U>&& other) noexcept : _pointer(other.detach()) {}
+        
+        intrusive_ptr& operator=(const intrusive_ptr& other) noexcept
+        {
+            intrusive_ptr(other).swap(*this);
+            return *this;
+        }
+        
+        intrusive_ptr& operator=(intrusive_ptr&& other) noexcept
+        {
+            intrusive_ptr(std::move(other)).swap(*this);
+            return *this;
+        }
+        
+        ~intrusive_ptr()
+        {
+            if (_pointer)
+                intrusive_ptr_release(_pointer);
+        }
+        
+        void reset() noexcept { intrusive_ptr().swap(*this); }
+        void swap(intrusive_ptr& other) noexcept { std::swap(_pointer, other._pointer); }
+        
+        /// Отдает указатель без уменьшения счетчика
+        T* detach() noexcept { return std::exchange(_pointer, nullptr); }
+        
+        T* get() const noexcept { return _pointer; }
+        T& operator*() const noexcept { return *_pointer; }
+        T* operator->() const noexcept { return _pointer; }
+        explicit operator bool() const noexcept { return _pointer != nullptr; }
+        
+        template <class U>
+        bool operator==(const intrusive_ptr<U>& other) const noexcept { return _pointer == other.get(); }
+    
+    private:
+        T* _pointer = nullptr;
+    };
+    
+    template <class T, class... Args>
+    intrusive_ptr<T> make_intrusive(Args&&... args)
+    {
+        return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+    }
+    
+    void Start();
+}
+
+#endif /* Intrusive_Ptr_hpp */
@@ -0,0 +1,143 @@
+#ifndef Lifetime_Probe_hpp
+#define Lifetime_Probe_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+
+/*
+ LifetimeProbe<Tag> - счетчики специальных методов класса (конструкторы, копирование, перемещение, деструктор) вместо печати в std::cout.
+ Печать с std::endl на каждое событие сбрасывает поток и под нагрузкой бесполезна, а атомарные счетчики можно проверять в тестах и замерах: «на этом пути нет ни одной копии».
+ Класс наследуется от LifetimeProbe<Класс> (CRTP-тег), свои копирующие/перемещающие конструкторы оставляет по умолчанию - тогда их вызовы считаются автоматически.
+ Для готового типа (std::string, std::vector) - Probed<T>.
+ Счетчики общие для всех потоков (relaxed atomic), каждый лежит в своей кэш-линии, чтобы разные события не мешали друг другу (false sharing).
+ */
+namespace lifetime_probe
+{
+    /// Снимок счетчиков
+    struct Counters
+    {
+        size_t constructed = 0;       // все конструкторы, кроме копирующего и перемещающего
+        size_t copy_constructed = 0;
+        size_t move_constructed = 0;
+        size_t copy_assigned = 0;
+        size_t move_assigned = 0;
+        size_t destroyed = 0;
+        size_t copied_bytes = 0;      // полезная нагрузка (payload), скопированная при копированиях
+        
+        size_t copies() const noexcept { return copy_constructed + copy_assigned; }
+        size_t moves() const noexcept { return move_constructed + move_assigned; }
+        
+        Counters operator-(const Counters& other) const noexcept
+        {
+            return {constructed - other.constructed, copy_constructed - other.copy_constructed, move_constructed - other.move_constructed,
+                    copy_assigned - other.copy_assigned, move_assigned - other.move_assigned, destroyed - other.destroyed,
+                    copied_bytes - other.copied_bytes};
+        }
+        
+        friend std::ostream& operator<<(std::ostream& stream, const Counters& counters)
+        {
+            return stream << "constructor: " << counters.constructed
+                          << ", copy constructor: " << counters.copy_constructed
+                          << ", move constructor: " << counters.move_constructed
+                          << ", copy assignment: " << counters.copy_assigned
+                          << ", move assignment: " << counters.move_assigned
+                          << ", destructor: " << counters.destroyed;
+        }
+    };
+    
+    template <class Tag>
+    class LifetimeProbe
+    {
+    public:
+        /// Замер событий между созданием Scope и вызовом diff()
+        class Scope
+        {
+        public:
+            Scope() noexcept : _start(snapshot()) {}
+            Counters diff() const noexcept { return snapshot() - _start; }
+        
+        private:
+            Counters _start;
+        };
+        
+        LifetimeProbe() noexcept { increment(_counters.constructed); }
+        explicit LifetimeProbe(size_t payload) noexcept : _payload(payload) { increment(_counters.constructed); }
+        
+        LifetimeProbe(const LifetimeProbe& other) noexcept : _payload(other._payload)
+        {
+            increment(_counters.copy_constructed);
+            increment(_counters.copied_bytes, _payload);
+        }
+        
+        LifetimeProbe(LifetimeProbe&& other) noexcept : _payload(other._payload)
+        {
+            increment(_counters.move_constructed);
+        }
+        
+        LifetimeProbe& operator=(const LifetimeProbe& other) noexcept
+        {
+            _payload = other._payload;
+            increment(_counters.copy_assigned);
+            increment(_counters.copied_bytes, _payload);
+            return *this;
+        }
+        
+        LifetimeProbe& operator=(LifetimeProbe&& other) noexcept
+        {
+            _payload = other._payload;
+            increment(_counters.move_assigned);
+            return *this;
+        }
+        
+        ~LifetimeProbe() { increment(_counters.destroyed); }
+        
+        static Counters snapshot() noexcept
+        {
+            return {load(_counters.constructed), load(_counters.copy_constructed), load(_counters.move_constructed),
+                    load(_counters.copy_assigned), load(_counters.move_assigned), load(_counters.destroyed),
+                    load(_counters.copied_bytes)};
+        }
+        
+        size_t payload() const noexcept { return _payload; }
+    
+    private:
+        struct alignas(64) Counter
+        {
+            std::atomic<size_t> value{0};
+        };
+        
+        struct Atomics
+        {
+            Counter constructed;
+            Counter copy_constructed;
+            Counter move_constructed;
+            Counter copy_assigned;
+            Counter move_assigned;
+            Counter destroyed;
+            Counter copied_bytes;
+        };
+        
+        static void increment(Counter& counter, size_t value = 1) noexcept
+        {
+            counter.value.fetch_add(value, std::memory_order_relaxed);
+        }
+        
+        static size_t load(const Counter& counter) noexcept
+        {
+            return counter.value.load(std::memory_order_relaxed);
+        }
+        
+        static inline Atomics _counters; // свои счетчики для каждого Tag
+        size_t _payload = 0;
+    };
+    
+    /// Зонд для готового типа: тот же T (конструкторы наследуются) со своими счетчиками
+    template <class T>
+    struct Probed : T, LifetimeProbe<Probed<T>>
+    {
+        using T::T;
+    };
+}
+
+#endif /* Lifetime_Probe_hpp */
@@ -0,0 +1,84 @@
+#include "Must_Elide.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+/*
+ Сайты: https://en.cppreference.com/w/cpp/language/copy_elision
+        https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2020/p2025r1.html
+ */
+
+namespace must_elide
+{
+    namespace
+    {
+        /// Большой возвращаемый тип из «горячего» пути
+        struct Order
+        {
+            explicit Order(size_t size) : items(size) {}
+            
+            std::vector<int> items;
+        };
+        
+        /// Фабрики из RVO&NRVO.cpp, записанные шаблоном по типу результата
+        auto RVO = []<class T>(std::type_identity<T>, size_t size)
+        {
+            return T(size);
+        };
+        
+        auto NRVO = []<class T>(std::type_identity<T>, size_t size)
+        {
+            T order(size);
+            order.items.front() = 1;
+            return order;
+        };
+        
+        auto NRVO_move = []<class T>(std::type_identity<T>, size_t size)
+        {
+            T order(size);
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpessimizing-move"
+#endif
+            return std::move(order); // NRVO отключается
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+        };
+        
+        /// Две именованные переменные: компилятор не знает заранее, какую строить на месте результата
+        auto NO_NRVO = []<class T>(std::type_identity<T>, size_t size)
+        {
+            T first(size);
+            T second(size * 2);
+            if (size % 2 == 0)
+                return first;
+            return second;
+        };
+        
+        // Гарантия на этапе компиляции: если кто-то перепишет фабрику через локальную переменную, сборка упадет
+        static_assert(must_elide<decltype(RVO), Order, size_t>());
+#if 0
+        static_assert(must_elide<decltype(NRVO), Order, size_t>());      // Ошибка: use of deleted function Pinned(Pinned&&)
+        static_assert(must_elide<decltype(NRVO_move), Order, size_t>()); // Ошибка: use of deleted function Pinned(Pinned&&)
+#endif
+    }
+    
+    void Start()
+    {
+        std::cout << "must elide" << std::endl;
+        
+        /// Проверка во время выполнения: NRVO зависит от компилятора и флагов
+        {
+            std::cout << std::boolalpha;
+            std::cout << "RVO: " << elides_at_runtime<decltype(RVO), Order>(size_t(1000)) << std::endl;             // true
+            std::cout << "NRVO: " << elides_at_runtime<decltype(NRVO), Order>(size_t(1000)) << std::endl;           // true (false с -fno-elide-constructors)
+            std::cout << "NRVO std::move: " << elides_at_runtime<decltype(NRVO_move), Order>(size_t(1000)) << std::endl; // false
+            std::cout << "NO NRVO: " << elides_at_runtime<decltype(NO_NRVO), Order>(size_t(1000)) << std::endl;     // false
+            std::cout << std::noboolalpha;
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef Must_Elide_hpp
+#define Must_Elide_hpp
+
+#include "Lifetime_Probe.hpp"
+
+#include <type_traits>
+#include <utility>
+
+/*
+ Проверка, что фабрика возвращает объект без копирования/перемещения.
+ Фабрика записывается шаблоном по типу результата T (generic lambda с параметром std::type_identity<T>), тогда ее можно инстанцировать не только для настоящего типа, но и для зонда:
+ - must_elide<Factory, T>() - проверка на этапе компиляции: фабрика инстанцируется для Pinned<T>, у которого удалены копирующий и перемещающий конструкторы.
+   Скомпилируется только возврат prvalue (return T(...);) - в C++17 это обязательный copy elision (RVO). return local; и return std::move(local); дают ошибку компиляции.
+   Ограничение: NRVO в C++ не гарантирована даже для подходящей локальной переменной и для некопируемого/неперемещаемого типа запрещена, поэтому на этапе компиляции ее доказать нельзя.
+ - elides_at_runtime<Factory, T>(args...) - проверка NRVO во время выполнения: фабрика инстанцируется для lifetime_probe::Probed<T>, который считает копирования/перемещения.
+   Зависит от компилятора и флагов (-fno-elide-constructors), поэтому годится для тестов в CI, а не для static_assert.
+ */
+namespace must_elide
+{
+    /// Зонд: тот же T, но без копирования и перемещения
+    template <class T>
+    struct Pinned : T
+    {
+        using T::T;
+        
+        Pinned(const Pinned&) = delete;
+        Pinned(Pinned&&) = delete;
+        Pinned& operator=(const Pinned&) = delete;
+        Pinned& operator=(Pinned&&) = delete;
+    };
+    
+    namespace detail
+    {
+        template <class Factory, class T, class... Args>
+        Pinned<T> instantiate(Args&&... args)
+        {
+            return Factory{}(std::type_identity<Pinned<T>>{}, std::forward<Args>(args)...);
+        }
+    }
+    
+    /// Проверка на этапе компиляции: static_assert(must_elide<Factory, T, Args...>())
+    template <class Factory, class T, class... Args>
+    constexpr bool must_elide() noexcept
+    {
+        static_assert(std::is_class_v<T> && !std::is_final_v<T>, "зонд Pinned<T> наследуется от T");
+        static_assert(std::is_default_constructible_v<Factory>, "фабрика - lambda без захвата или функциональный объект");
+        using Result = std::invoke_result_t<Factory, std::type_identity<Pinned<T>>, Args...>;
+        static_assert(std::is_same_v<Result, Pinned<T>>, "фабрика должна возвращать T по значению");
+        
+        // Взятие адреса инстанцирует тело фабрики для Pinned<T>: копирование/перемещение результата - ошибка компиляции
+        [[maybe_unused]] auto instance = &detail::instantiate<Factory, T, Args...>;
+        return true;
+    }
+    
+    /// Проверка во время выполнения (в том числе NRVO): ни одного копирования/перемещения результата
+    template <class Factory, class T, class... Args>
+    bool elides_at_runtime(Args&&... args)
+    {
+        typename lifetime_probe::Probed<T>::Scope scope;
+        {
+            [[maybe_unused]] auto result = Factory{}(std::type_identity<lifetime_probe::Probed<T>>{}, std::forward<Args>(args)...);
+        }
+        const auto diff = scope.diff();
+        return diff.copies() == 0 && diff.moves() == 0;
+    }
+    
+    void Start();
+}
+
+#endif /* Must_Elide_hpp */
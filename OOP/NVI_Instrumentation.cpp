@@ -0,0 +1,294 @@
+#ifndef NVI_INSTRUMENTATION
+#define NVI_INSTRUMENTATION // пример всегда собирается с инструментированием
+#endif
+
+#include "NVI_Instrumentation.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+/*
+ Сайты: http://www.gotw.ca/publications/mill18.htm
+        https://en.wikipedia.org/wiki/Non-virtual_interface_pattern
+ */
+
+namespace nvi_instrumentation
+{
+    namespace
+    {
+        std::string demangle(const std::type_info& type)
+        {
+#if defined(__GNUG__)
+            int status = 0;
+            std::unique_ptr<char, void (*)(void*)> name(abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), std::free);
+            if (status == 0 && name)
+                return name.get();
+#endif
+            return type.name();
+        }
+        
+        /// Счетчики потока: фиксированный массив, чтобы aggregate() мог читать его параллельно с записью
+        struct ThreadTable
+        {
+            static constexpr size_t capacity = 64;
+            
+            ThreadTable();
+            ~ThreadTable();
+            
+            detail::Slot& find(const std::type_info& type)
+            {
+                if (_last && *_last->type.load(std::memory_order_relaxed) == type) // тот же тип, что и в прошлый раз
+                    return *_last;
+                
+                const size_t count = size.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (*slots[i].type.load(std::memory_order_relaxed) == type)
+                        return *(_last = &slots[i]);
+                }
+                if (count == capacity)
+                    return overflow;
+                
+                slots[count].type.store(&type, std::memory_order_relaxed);
+                size.store(count + 1, std::memory_order_release); // слот публикуется после записи типа
+                return *(_last = &slots[count]);
+            }
+            
+            detail::Slot slots[capacity];
+            detail::Slot overflow; // типы сверх capacity
+            std::atomic<size_t> size{0};
+        
+        private:
+            detail::Slot* _last = nullptr;
+        };
+        
+        /// Живые таблицы потоков + накопленные счетчики завершившихся потоков
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<const ThreadTable*> tables;
+            std::map<std::type_index, Statistic> retired;
+            Statistic retired_overflow;
+        };
+        
+        Registry& registry()
+        {
+            static Registry registry;
+            return registry;
+        }
+        
+        void accumulate(Statistic& statistic, const detail::Slot& slot)
+        {
+            statistic.calls += slot.calls.load(std::memory_order_relaxed);
+            statistic.samples += slot.samples.load(std::memory_order_relaxed);
+            statistic.sampled_ns += slot.sampled_ns.load(std::memory_order_relaxed);
+            statistic.max_ns = std::max(statistic.max_ns, slot.max_ns.load(std::memory_order_relaxed));
+        }
+        
+        /// Вызывается под mutex реестра
+        void accumulate(std::map<std::type_index, Statistic>& statistics, Statistic& overflow, const ThreadTable& table)
+        {
+            const size_t count = table.size.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const std::type_info& type = *table.slots[i].type.load(std::memory_order_relaxed);
+                Statistic& statistic = statistics[std::type_index(type)];
+                if (statistic.type.empty())
+                    statistic.type = demangle(type);
+                accumulate(statistic, table.slots[i]);
+            }
+            accumulate(overflow, table.overflow);
+        }
+        
+        ThreadTable::ThreadTable()
+        {
+            Registry& registry = nvi_instrumentation::registry();
+            std::lock_guard lock(registry.mutex);
+            registry.tables.push_back(this);
+        }
+        
+        ThreadTable::~ThreadTable()
+        {
+            Registry& registry = nvi_instrumentation::registry();
+            std::lock_guard lock(registry.mutex);
+            accumulate(registry.retired, registry.retired_overflow, *this);
+            registry.tables.erase(std::find(registry.tables.begin(), registry.tables.end(), this));
+        }
+        
+        thread_local ThreadTable table;
+    }
+    
+    detail::Slot& detail::slot(const std::type_info& type)
+    {
+        return table.find(type);
+    }
+    
+    std::vector<Statistic> aggregate()
+    {
+        std::map<std::type_index, Statistic> statistics;
+        Statistic overflow;
+        {
+            Registry& registry = nvi_instrumentation::registry();
+            std::lock_guard lock(registry.mutex);
+            statistics = registry.retired;
+            overflow = registry.retired_overflow;
+            for (const ThreadTable* table : registry.tables)
+                accumulate(statistics, overflow, *table);
+        }
+        
+        std::vector<Statistic> result;
+        result.reserve(statistics.size() + 1);
+        for (auto& [type, statistic] : statistics)
+            result.push_back(std::move(statistic));
+        if (overflow.calls)
+        {
+            overflow.type = "<другие типы>";
+            result.push_back(std::move(overflow));
+        }
+        std::sort(result.begin(), result.end(), [](const Statistic& lhs, const Statistic& rhs) { return lhs.calls > rhs.calls; });
+        return result;
+    }
+    
+    namespace
+    {
+        /// NVI как в Virtual.cpp: невиртуальный print - единственная точка входа в print_impl
+        struct Base
+        {
+            virtual ~Base() = default;
+            
+            int print(int number) const
+            {
+                NVI_PROBE(*this);
+                return print_impl(number);
+            }
+        
+        private:
+            virtual int print_impl(int number) const = 0;
+        };
+        
+        struct Hot final : Base
+        {
+            int print_impl(int number) const override { return number + 1; }
+        };
+        
+        struct Warm final : Base
+        {
+            int print_impl(int number) const override { return number * 2; }
+        };
+        
+        struct Cold final : Base
+        {
+            int print_impl(int number) const override
+            {
+                unsigned result = static_cast<unsigned>(number);
+                for (unsigned i = 0; i < 1000; ++i) // редкий, но медленный вызов
+                    result = result * 31 + i;
+                benchmark::do_not_optimize(result);
+                return static_cast<int>(result & 0xFF);
+            }
+        };
+        
+        /// Тот же NVI без инструментирования (как при сборке без NVI_INSTRUMENTATION)
+        struct PlainBase
+        {
+            virtual ~PlainBase() = default;
+            int print(int number) const { return print_impl(number); }
+        
+        private:
+            virtual int print_impl(int number) const = 0;
+        };
+        
+        struct PlainHot final : PlainBase
+        {
+            int print_impl(int number) const override { return number + 1; }
+        };
+        
+        struct PlainWarm final : PlainBase
+        {
+            int print_impl(int number) const override { return number * 2; }
+        };
+        
+        void print(const std::vector<Statistic>& statistics)
+        {
+            for (const auto& statistic : statistics)
+            {
+                std::cout << statistic.type << ": calls " << statistic.calls << ", samples " << statistic.samples
+                          << ", mean " << statistic.mean_ns() << " ns, max " << statistic.max_ns << " ns" << std::endl;
+            }
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "NVI instrumentation" << std::endl;
+        
+        /// Вызовы из 2 потоков: счетчики завершившегося потока тоже попадают в отчет
+        {
+            const Hot hot;
+            const Warm warm;
+            const Cold cold;
+            auto work = [&](int iterations)
+            {
+                long long sum = 0;
+                for (int i = 0; i < iterations; ++i)
+                {
+                    sum += hot.print(i);
+                    if (i % 4 == 0)
+                        sum += warm.print(i);
+                    if (i % 256 == 0)
+                        sum += cold.print(i);
+                }
+                benchmark::do_not_optimize(sum);
+            };
+            
+            std::thread thread(work, 100'000);
+            work(100'000);
+            thread.join();
+            
+            print(aggregate()); // Hot: calls 200000, Warm: calls 50000, Cold: calls 782 - но самые долгие вызовы у Cold
+        }
+        
+        /*
+         Цена инструментирования на вызов: поиск счетчика потока + его запись + часы на каждом sample_period-м вызове.
+         Замеренная задержка включает и цену самих часов (десятки нс), поэтому она полезна для сравнения типов между собой, а не как абсолютное время.
+         */
+        {
+            constexpr int count = 1'000'000;
+            const Hot hot;
+            const Warm warm;
+            const PlainHot plain_hot;
+            const PlainWarm plain_warm;
+            const Base* const instrumented[] = {&hot, &warm}; // 2 типа: компилятор не может убрать виртуальный вызов
+            const PlainBase* const plain[] = {&plain_hot, &plain_warm};
+            
+            const double instrumented_ns = benchmark::measure_ns([&]
+            {
+                long long sum = 0;
+                for (int i = 0; i < count; ++i)
+                    sum += instrumented[i & 1]->print(i);
+                benchmark::do_not_optimize(sum);
+            }) / count;
+            const double plain_ns = benchmark::measure_ns([&]
+            {
+                long long sum = 0;
+                for (int i = 0; i < count; ++i)
+                    sum += plain[i & 1]->print(i);
+                benchmark::do_not_optimize(sum);
+            }) / count;
+            
+            std::cout << "без инструментирования: " << plain_ns << " ns/call, с NVI_PROBE: " << instrumented_ns << " ns/call" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef NVI_Instrumentation_hpp
+#define NVI_Instrumentation_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/*
+ Инструментирование NVI (non virtual interface, Virtual.cpp): невиртуальный метод базового класса - единственная точка входа в виртуальную реализацию, поэтому в нем удобно считать вызовы по динамическому типу объекта.
+ NVI_PROBE(*this) в начале невиртуального метода:
+ - считает вызовы для typeid(*this) в счетчиках своего потока (thread_local, без общих атомарных операций и блокировок);
+ - каждый sample_period-й вызов замеряет время до выхода из метода (выборка, чтобы не платить за часы на каждом вызове).
+ aggregate() собирает счетчики всех потоков (в том числе завершившихся) и сортирует типы по числу вызовов - так находятся горячие переопределения.
+ Включается флагом компиляции NVI_INSTRUMENTATION, без него NVI_PROBE разворачивается в пустое выражение и ничего не стоит.
+ */
+namespace nvi_instrumentation
+{
+    /// Каждый sample_period-й вызов замеряется (степень 2)
+    inline constexpr std::uint64_t sample_period = 64;
+    
+    struct Statistic
+    {
+        std::string type;
+        std::uint64_t calls = 0;
+        std::uint64_t samples = 0;
+        std::uint64_t sampled_ns = 0;
+        std::uint64_t max_ns = 0;
+        
+        double mean_ns() const noexcept { return samples ? double(sampled_ns) / double(samples) : 0.0; }
+    };
+    
+    /// Счетчики всех потоков по типам, по убыванию числа вызовов
+    std::vector<Statistic> aggregate();
+    
+    namespace detail
+    {
+        /// Счетчики одного типа в одном потоке: пишет только поток-владелец, aggregate() только читает
+        struct Slot
+        {
+            std::atomic<const std::type_info*> type{nullptr};
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> samples{0};
+            std::atomic<std::uint64_t> sampled_ns{0};
+            std::atomic<std::uint64_t> max_ns{0};
+        };
+        
+        Slot& slot(const std::type_info& type);
+        
+        inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); // один писатель: без lock-префикса
+        }
+    }
+    
+    class Probe
+    {
+    public:
+        explicit Probe(const std::type_info& type) : _slot(detail::slot(type))
+        {
+            const std::uint64_t calls = _slot.calls.load(std::memory_order_relaxed);
+            _slot.calls.store(calls + 1, std::memory_order_relaxed);
+            _sampled = (calls & (sample_period - 1)) == 0;
+            if (_sampled)
+                _start = std::chrono::steady_clock::now();
+        }
+        
+        ~Probe()
+        {
+            if (!_sampled)
+                return;
+            
+            const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+            detail::add(_slot.samples, 1);
+            detail::add(_slot.sampled_ns, elapsed);
+            if (elapsed > _slot.max_ns.load(std::memory_order_relaxed))
+                _slot.max_ns.store(elapsed, std::memory_order_relaxed);
+        }
+        
+        Probe(const Probe&) = delete;
+        Probe& operator=(const Probe&) = delete;
+    
+    private:
+        detail::Slot& _slot;
+        std::chrono::steady_clock::time_point _start;
+        bool _sampled;
+    };
+    
+    void Start();
+}
+
+#if defined(NVI_INSTRUMENTATION)
+#define NVI_PROBE(object) const ::nvi_instrumentation::Probe nvi_probe_(typeid(object))
+#else
+#define NVI_PROBE(object) ((void)0)
+#endif
+
+#endif /* NVI_Instrumentation_hpp */
@@ -0,0 +1,153 @@
+#include "Noexcept_Audit.hpp"
+#include "Benchmark.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+/*
+ Сайты: https://en.cppreference.com/w/cpp/utility/move_if_noexcept
+        https://en.cppreference.com/w/cpp/language/rule_of_three
+ */
+
+namespace noexcept_audit
+{
+    std::vector<Report>& registry()
+    {
+        static std::vector<Report> reports; // локальная статическая переменная: создается при первой регистрации, порядок инициализации единиц трансляции не важен
+        return reports;
+    }
+    
+    const char* to_string(Relocation relocation) noexcept
+    {
+        switch (relocation)
+        {
+            case Relocation::trivial: return "trivial";
+            case Relocation::move: return "move";
+            case Relocation::throwing_move: return "throwing move";
+            case Relocation::copy: return "COPY";
+            case Relocation::impossible: return "impossible";
+        }
+        return "";
+    }
+    
+    namespace
+    {
+        /// Правило нуля: все специальные методы неявные, перемещение noexcept
+        struct RuleOfZero
+        {
+            std::string name;
+            std::vector<int> values;
+        };
+        
+        /// Пустой деструктор подавляет неявное перемещение: вектор копирует строку и вектор
+        struct UserDestructor
+        {
+            ~UserDestructor() {}
+            
+            std::string name;
+            std::vector<int> values;
+        };
+        
+        /// Перемещение без noexcept: вектор выбирает копирование
+        struct ThrowingMove
+        {
+            ThrowingMove() = default;
+            ThrowingMove(const ThrowingMove&) = default;
+            ThrowingMove(ThrowingMove&& other) : name(std::move(other.name)), values(std::move(other.values)) {}
+            ThrowingMove& operator=(const ThrowingMove&) = default;
+            ThrowingMove& operator=(ThrowingMove&&) = default;
+            
+            std::string name;
+            std::vector<int> values;
+        };
+        
+        /// Деструктор нужен - тогда перемещение объявляется явно и noexcept (правило пяти)
+        struct NoexceptMove
+        {
+            NoexceptMove() = default;
+            NoexceptMove(const NoexceptMove&) = default;
+            NoexceptMove(NoexceptMove&&) noexcept = default;
+            NoexceptMove& operator=(const NoexceptMove&) = default;
+            NoexceptMove& operator=(NoexceptMove&&) noexcept = default;
+            ~NoexceptMove() {}
+            
+            std::string name;
+            std::vector<int> values;
+        };
+        
+        NOEXCEPT_AUDIT_REQUIRE(RuleOfZero);
+        NOEXCEPT_AUDIT_REQUIRE(NoexceptMove);
+        // NOEXCEPT_AUDIT_REQUIRE(ThrowingMove); // Ошибка: ThrowingMove: нужен noexcept конструктор перемещения
+        
+        static_assert(has_move_constructor<RuleOfZero> && has_move_constructor<NoexceptMove>);
+        static_assert(!has_move_constructor<UserDestructor>); // перемещение выполняет копирующий конструктор
+        
+        template <class T>
+        double push_back_ms(size_t size)
+        {
+            return benchmark::measure_ms([size]
+            {
+                std::vector<T> objects; // без reserve: log2(size) переносов всех элементов
+                for (size_t i = 0; i < size; ++i)
+                {
+                    T& object = objects.emplace_back();
+                    object.name.assign(32, 'x'); // длиннее SSO: копия строки - выделение памяти
+                    object.values.assign(8, static_cast<int>(i));
+                }
+                benchmark::do_not_optimize(objects.back().values.front());
+            }, 3);
+        }
+    }
+}
+
+NOEXCEPT_AUDIT(noexcept_audit::RuleOfZero);
+NOEXCEPT_AUDIT(noexcept_audit::UserDestructor);
+NOEXCEPT_AUDIT(noexcept_audit::ThrowingMove);
+NOEXCEPT_AUDIT(noexcept_audit::NoexceptMove);
+
+namespace noexcept_audit
+{
+    void Start()
+    {
+        std::cout << "noexcept audit" << std::endl;
+        
+        /*
+         Отчет по всем зарегистрированным типам проекта.
+         Классы из Initialization.cpp, Inheritance.cpp и Virtual.cpp объявляют деструктор, поэтому неявного перемещения у них нет - вектор их копирует.
+         Для пустых классов это ничего не стоит, а initialization_order::D/E с полями std::shared_ptr при каждом переносе атомарно увеличивают и уменьшают счетчики ссылок.
+         Копирование shared_ptr - noexcept, поэтому nothrow move ctor = yes, но конструктора перемещения нет - отчет показывает COPY.
+         */
+        {
+            std::cout << std::left << std::setw(22) << "file" << std::setw(44) << "type" << std::setw(12) << "nothrow" << std::setw(12) << "nothrow" << std::setw(12) << "nothrow"
+                      << "vector growth" << std::endl;
+            std::cout << std::setw(66) << "" << std::setw(12) << "move ctor" << std::setw(12) << "move =" << std::setw(12) << "dtor" << std::endl;
+            for (const auto& report : registry())
+            {
+                const std::string_view file = report.file;
+                std::cout << std::setw(22) << file.substr(file.find_last_of("/\\") + 1) << std::setw(44) << report.name
+                          << std::setw(12) << (report.nothrow_move_constructible ? "yes" : "NO")
+                          << std::setw(12) << (report.nothrow_move_assignable ? "yes" : "NO")
+                          << std::setw(12) << (report.nothrow_destructible ? "yes" : "NO")
+                          << to_string(report.relocation) << std::endl;
+            }
+            std::cout << std::right;
+        }
+        
+        /*
+         Стоимость переноса при росте вектора: RuleOfZero и NoexceptMove перемещают (обмен указателями),
+         UserDestructor и ThrowingMove копируют строку и вектор каждого элемента (выделения памяти + memcpy) на каждом переносе.
+         */
+        {
+            constexpr size_t size = 100'000;
+            std::cout << "push_back " << size << " элементов без reserve:" << std::endl;
+            std::cout << "RuleOfZero: " << push_back_ms<RuleOfZero>(size) << " ms" << std::endl;
+            std::cout << "NoexceptMove: " << push_back_ms<NoexceptMove>(size) << " ms" << std::endl;
+            std::cout << "UserDestructor: " << push_back_ms<UserDestructor>(size) << " ms" << std::endl;
+            std::cout << "ThrowingMove: " << push_back_ms<ThrowingMove>(size) << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef Noexcept_Audit_hpp
+#define Noexcept_Audit_hpp
+
+#include <type_traits>
+#include <vector>
+
+/*
+ Аудит noexcept перемещения.
+ При росте std::vector переносит элементы в новую память через std::move_if_noexcept: перемещение - только если конструктор перемещения noexcept (или копирования нет вовсе), иначе - копирование ради строгой гарантии исключений.
+ Ловушки:
+ - пользовательский деструктор (даже пустой ~A() {}) или копирующий конструктор подавляют неявный конструктор перемещения - тип «перемещается» копированием.
+   is_nothrow_move_constructible этого не видит: если копирование членов не бросает (int, std::shared_ptr), трейт равен true.
+   Поэтому audit<T>() отдельно проверяет, объявлен ли конструктор перемещения (has_move_constructor), и такие типы тоже показывает как COPY;
+ - конструктор перемещения без noexcept - вектор копирует.
+ audit<T>() - constexpr, поэтому нужное свойство можно потребовать на этапе компиляции (NOEXCEPT_AUDIT_REQUIRE), а NOEXCEPT_AUDIT регистрирует тип для общего отчета во время выполнения.
+ */
+namespace noexcept_audit
+{
+    namespace detail
+    {
+        /// Преобразуется и в T&&, и в const T&: если у T есть оба конструктора T(T&&) и T(const T&), построение T неоднозначно
+        template <class T>
+        struct either_reference
+        {
+            operator T&&() const noexcept;
+            operator const T&() const noexcept;
+        };
+    }
+    
+    /*
+     Конструктор перемещения объявлен (явно или неявно), а не подменен копирующим.
+     Проверяется только сам T: неявное перемещение наследника копирует базу без конструктора перемещения, а конструктор-шаблон из любого типа (как у std::any) проверку обманывает.
+     */
+    template <class T>
+    inline constexpr bool has_move_constructor = !std::is_constructible_v<T, detail::either_reference<T>>;
+    
+    /// Как std::vector переносит элементы при росте
+    enum class Relocation
+    {
+        trivial,       // trivially copyable: побайтовое копирование (memmove)
+        move,          // noexcept перемещение
+        throwing_move, // перемещение может бросить, копирования нет: строгая гарантия исключений теряется
+        copy,          // копирование: перемещение не noexcept или конструктора перемещения нет
+        impossible     // нельзя ни переместить, ни скопировать (например, абстрактный класс)
+    };
+    
+    struct Report
+    {
+        const char* name = nullptr;
+        const char* file = "";
+        bool nothrow_move_constructible = false;
+        bool nothrow_move_assignable = false;
+        bool nothrow_destructible = false;
+        Relocation relocation = Relocation::impossible;
+    };
+    
+    template <class T>
+    constexpr Report audit(const char* name) noexcept
+    {
+        Report report;
+        report.name = name;
+        report.nothrow_move_constructible = std::is_nothrow_move_constructible_v<T>;
+        report.nothrow_move_assignable = std::is_nothrow_move_assignable_v<T>;
+        report.nothrow_destructible = std::is_nothrow_destructible_v<T>;
+        
+        if (!std::is_move_constructible_v<T>)
+            report.relocation = Relocation::impossible;
+        else if (std::is_trivially_copyable_v<T>)
+            report.relocation = Relocation::trivial;
+        else if (std::is_nothrow_move_constructible_v<T> && has_move_constructor<T>)
+            report.relocation = Relocation::move;
+        else if (!std::is_copy_constructible_v<T>)
+            report.relocation = Relocation::throwing_move;
+        else
+            report.relocation = Relocation::copy;
+        return report;
+    }
+    
+    /// Все зарегистрированные типы (заполняется до main статическими объектами Registrar)
+    std::vector<Report>& registry();
+    
+    template <class T>
+    struct Registrar
+    {
+        Registrar(const char* name, const char* file)
+        {
+            Report report = audit<T>(name);
+            report.file = file;
+            registry().push_back(report);
+        }
+    };
+    
+    const char* to_string(Relocation relocation) noexcept;
+    
+    void Start();
+}
+
+#define NOEXCEPT_AUDIT_CONCAT_IMPL(left, right) left##right
+#define NOEXCEPT_AUDIT_CONCAT(left, right) NOEXCEPT_AUDIT_CONCAT_IMPL(left, right)
+
+/// Регистрация типа в отчете: NOEXCEPT_AUDIT(namespace::Type);
+#define NOEXCEPT_AUDIT(Type) \
+    static const noexcept_audit::Registrar<Type> NOEXCEPT_AUDIT_CONCAT(noexcept_audit_registrar_, __LINE__){#Type, __FILE__}
+
+/// Ошибка компиляции, если std::vector<Type> будет копировать элементы при росте
+#define NOEXCEPT_AUDIT_REQUIRE(Type) \
+    static_assert(noexcept_audit::audit<Type>(#Type).relocation != noexcept_audit::Relocation::copy && \
+                  noexcept_audit::audit<Type>(#Type).relocation != noexcept_audit::Relocation::throwing_move, \
+                  #Type ": нужен noexcept конструктор перемещения, иначе std::vector копирует элементы при росте")
+
+#endif /* Noexcept_Audit_hpp */
@@ -0,0 +1,186 @@
+#include "Object_Pool.hpp"
+#include "Benchmark.hpp"
+
+#include <iostream>
+#include <string>
+
+/*
+ Сайты: https://gameprogrammingpatterns.com/object-pool.html
+        https://www.boost.org/doc/libs/release/libs/pool/doc/html/index.html
+ */
+
+namespace object_pool
+{
+    namespace
+    {
+        /// Как в Virtual.cpp: объекты удаляются через виртуальный деструктор
+        namespace heap
+        {
+            struct Base
+            {
+                virtual ~Base() = default;
+                virtual int print(int number) const = 0;
+            };
+            
+            struct Derived1 final : Base
+            {
+                explicit Derived1(int data) : data(data) {}
+                int print(int number) const override { return number + data; }
+                
+                int data;
+            };
+            
+            struct Derived2 final : Base
+            {
+                explicit Derived2(int data) : data{double(data), 0.5} {}
+                int print(int number) const override { return number * 2 + int(data[0]); }
+                
+                double data[2];
+            };
+        }
+        
+        /// Для пула виртуальный деструктор не нужен: защищенный невиртуальный деструктор запрещает delete через Base*, а наследники остаются trivially destructible
+        namespace pooled
+        {
+            struct Base
+            {
+                virtual int print(int number) const = 0;
+            
+            protected:
+                ~Base() = default;
+            };
+            
+            struct Derived1 final : Base
+            {
+                explicit Derived1(int data) : data(data) {}
+                int print(int number) const override { return number + data; }
+                
+                int data;
+            };
+            
+            struct Derived2 final : Base
+            {
+                explicit Derived2(int data) : data{double(data), 0.5} {}
+                int print(int number) const override { return number * 2 + int(data[0]); }
+                
+                double data[2];
+            };
+            
+            /// Нетривиальный деструктор: clear() вызывает его для каждого живого объекта
+            struct Named final : Base
+            {
+                explicit Named(int data) : name(64, char('a' + data % 26)) {}
+                int print(int number) const override { return number + int(name.size()); }
+                
+                std::string name;
+            };
+            
+            static_assert(std::is_trivially_destructible_v<Derived1> && std::is_trivially_destructible_v<Derived2>);
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "object pool" << std::endl;
+        
+        /// pooled_ptr возвращает объект в свой пул
+        {
+            pools<pooled::Derived1, pooled::Derived2, pooled::Named> pools;
+            {
+                const pooled_ptr<pooled::Base> derived1 = pools.make<pooled::Derived1, pooled::Base>(1);
+                const pooled_ptr<pooled::Base> named = pools.make<pooled::Named, pooled::Base>(2);
+                std::cout << derived1->print(10) << " " << named->print(10) << ", объектов: " << pools.size() << std::endl; // 11 74, объектов: 2
+            }
+            std::cout << "объектов: " << pools.size() << std::endl; // 0
+            
+            for (int i = 0; i < 1000; ++i)
+                pools.get<pooled::Named>().construct(i);
+            pools.clear(); // 1000 деструкторов Named, память остается в пуле
+            std::cout << "после clear: " << pools.size() << ", емкость Named: " << pools.get<pooled::Named>().capacity() << std::endl; // 0, 1024
+        }
+        
+        /*
+         Создание и удаление 100000 объектов двух типов, 20 раз:
+         - new/delete: malloc/free на каждый объект + виртуальный деструктор;
+         - pooled_ptr: ячейка из списка свободных, удаление через пул настоящего типа;
+         - construct + clear(): объекты без владельцев, удаляются все разом - для trivially destructible типов без деструкторов.
+         */
+        {
+            constexpr int count = 100'000;
+            constexpr int rounds = 20;
+            long long heap_sum = 0, pooled_sum = 0, cleared_sum = 0;
+            
+            const double heap_ms = benchmark::measure_ms([&]
+            {
+                heap_sum = 0;
+                std::vector<std::unique_ptr<heap::Base>> objects;
+                objects.reserve(count);
+                for (int round = 0; round < rounds; ++round)
+                {
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (i & 1)
+                            objects.push_back(std::make_unique<heap::Derived2>(i));
+                        else
+                            objects.push_back(std::make_unique<heap::Derived1>(i));
+                    }
+                    for (const auto& object : objects)
+                        heap_sum += object->print(round);
+                    objects.clear();
+                }
+                benchmark::do_not_optimize(heap_sum);
+            }, 3);
+            
+            pools<pooled::Derived1, pooled::Derived2> pools(1024);
+            const double pooled_ms = benchmark::measure_ms([&]
+            {
+                pooled_sum = 0;
+                std::vector<pooled_ptr<pooled::Base>> objects;
+                objects.reserve(count);
+                for (int round = 0; round < rounds; ++round)
+                {
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (i & 1)
+                            objects.push_back(pools.make<pooled::Derived2, pooled::Base>(i));
+                        else
+                            objects.push_back(pools.make<pooled::Derived1, pooled::Base>(i));
+                    }
+                    for (const auto& object : objects)
+                        pooled_sum += object->print(round);
+                    objects.clear();
+                }
+                benchmark::do_not_optimize(pooled_sum);
+            }, 3);
+            
+            const double cleared_ms = benchmark::measure_ms([&]
+            {
+                cleared_sum = 0;
+                std::vector<pooled::Base*> objects;
+                objects.reserve(count);
+                for (int round = 0; round < rounds; ++round)
+                {
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (i & 1)
+                            objects.push_back(pools.get<pooled::Derived2>().construct(i));
+                        else
+                            objects.push_back(pools.get<pooled::Derived1>().construct(i));
+                    }
+                    for (const pooled::Base* object : objects)
+                        cleared_sum += object->print(round);
+                    objects.clear();
+                    pools.clear();
+                }
+                benchmark::do_not_optimize(cleared_sum);
+            }, 3);
+            
+            std::cout << "суммы " << (heap_sum == pooled_sum && pooled_sum == cleared_sum ? "совпадают" : "НЕ совпадают") << std::endl;
+            std::cout << "new/delete: " << heap_ms << " ms" << std::endl;
+            std::cout << "object_pool + pooled_ptr: " << pooled_ms << " ms" << std::endl;
+            std::cout << "object_pool + clear(): " << cleared_ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
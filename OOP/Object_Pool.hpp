@@ -0,0 +1,200 @@
+#ifndef Object_Pool_hpp
+#define Object_Pool_hpp
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ Пулы объектов для полиморфных иерархий: свой пул на каждый динамический тип.
+ В Virtual.cpp и Inheritance.cpp объекты создаются и удаляются по одному через new/delete и виртуальный деструктор: каждый объект - отдельный вызов malloc/free и поиск деструктора через vptr.
+ object_pool<T>:
+ - память выделяется блоками (chunk) по chunk_size объектов, освобожденные ячейки уходят в список свободных (free list) и переиспользуются;
+ - make<Base>(args...) возвращает pooled_ptr<Base> - владеющий указатель, который возвращает объект в свой пул и вызывает деструктор T напрямую, без поиска через vptr (виртуальный деструктор в Base для пула не нужен);
+ - clear() уничтожает все объекты пула разом и оставляет блоки памяти для повторного использования; для trivially destructible T деструкторы не вызываются вообще - clear() за O(1).
+ После clear() все указатели на объекты пула (в том числе pooled_ptr) недействительны.
+ */
+namespace object_pool
+{
+    /// Удаляет объект через его пул: функция знает настоящий тип и приводит Base* к нему (корректно и при множественном наследовании).
+    /// Цена: pooled_ptr занимает 3 указателя вместо 1 у std::unique_ptr<Base>
+    template <class Base>
+    struct pool_deleter
+    {
+        void* pool = nullptr;
+        void (*release)(void* pool, Base* object) noexcept = nullptr;
+        
+        void operator()(Base* object) const noexcept { release(pool, object); }
+    };
+    
+    template <class Base>
+    using pooled_ptr = std::unique_ptr<Base, pool_deleter<Base>>;
+    
+    template <class T>
+    class object_pool
+    {
+        static constexpr bool trivial = std::is_trivially_destructible_v<T>;
+        
+        struct Empty {};
+        
+        struct Slot
+        {
+            union
+            {
+                alignas(T) std::byte storage[sizeof(T)];
+                Slot* next; // ячейка в списке свободных
+            };
+            [[no_unique_address]] std::conditional_t<trivial, Empty, bool> live; // только для clear() с деструкторами
+        };
+    
+    public:
+        explicit object_pool(size_t chunk_size = 256) : _chunk_size(chunk_size ? chunk_size : 1) {}
+        ~object_pool() { clear(); }
+        
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+        
+        template <class... Args>
+        T* construct(Args&&... args)
+        {
+            Slot* slot = allocate();
+            T* object;
+            try
+            {
+                object = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                deallocate(slot);
+                throw;
+            }
+            if constexpr (!trivial)
+                slot->live = true;
+            ++_size;
+            return object;
+        }
+        
+        void destroy(T* object) noexcept
+        {
+            if constexpr (!trivial)
+                object->T::~T(); // квалифицированный вызов: без поиска через vptr
+            Slot* slot = reinterpret_cast<Slot*>(object);
+            if constexpr (!trivial)
+                slot->live = false;
+            deallocate(slot);
+            --_size;
+        }
+        
+        template <class Base = T, class... Args>
+        pooled_ptr<Base> make(Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Base, T>, "T должен наследоваться от Base");
+            return pooled_ptr<Base>(construct(std::forward<Args>(args)...), pool_deleter<Base>{this, &release<Base>});
+        }
+        
+        /// Уничтожение всех объектов; блоки памяти остаются для следующих объектов
+        void clear() noexcept
+        {
+            if constexpr (!trivial)
+            {
+                for (size_t chunk = 0; chunk < _chunks.size() && chunk <= _chunk; ++chunk)
+                {
+                    const size_t used = chunk < _chunk ? _chunk_size : _used;
+                    for (size_t i = 0; i < used; ++i)
+                    {
+                        Slot& slot = _chunks[chunk][i];
+                        if (slot.live)
+                        {
+                            std::launder(reinterpret_cast<T*>(slot.storage))->T::~T();
+                            slot.live = false;
+                        }
+                    }
+                }
+            }
+            _free = nullptr;
+            _chunk = 0;
+            _used = 0;
+            _size = 0;
+        }
+        
+        /// Освобождение памяти всех блоков
+        void shrink() noexcept
+        {
+            clear();
+            _chunks.clear();
+        }
+        
+        size_t size() const noexcept { return _size; }
+        size_t capacity() const noexcept { return _chunks.size() * _chunk_size; }
+    
+    private:
+        template <class Base>
+        static void release(void* pool, Base* object) noexcept
+        {
+            static_cast<object_pool*>(pool)->destroy(static_cast<T*>(object));
+        }
+        
+        Slot* allocate()
+        {
+            if (_free)
+            {
+                Slot* slot = _free;
+                _free = slot->next;
+                return slot;
+            }
+            if (_chunks.empty() || _used == _chunk_size)
+            {
+                if (!_chunks.empty())
+                {
+                    ++_chunk;
+                    _used = 0;
+                }
+                if (_chunk == _chunks.size())
+                    _chunks.push_back(std::make_unique<Slot[]>(_chunk_size));
+            }
+            return &_chunks[_chunk][_used++];
+        }
+        
+        void deallocate(Slot* slot) noexcept
+        {
+            slot->next = _free;
+            _free = slot;
+        }
+        
+        std::vector<std::unique_ptr<Slot[]>> _chunks;
+        size_t _chunk_size;
+        size_t _chunk = 0;   // текущий блок
+        size_t _used = 0;    // занято ячеек в текущем блоке
+        Slot* _free = nullptr;
+        size_t _size = 0;
+    };
+    
+    /// Пулы для всех типов иерархии
+    template <class... Types>
+    class pools
+    {
+    public:
+        explicit pools(size_t chunk_size = 256) : _pools(((void)sizeof(Types), chunk_size)...) {}
+        
+        template <class T>
+        object_pool<T>& get() noexcept { return std::get<object_pool<T>>(_pools); }
+        
+        template <class T, class Base = T, class... Args>
+        pooled_ptr<Base> make(Args&&... args) { return get<T>().template make<Base>(std::forward<Args>(args)...); }
+        
+        void clear() noexcept { (get<Types>().clear(), ...); }
+        
+        size_t size() const noexcept { return (std::get<object_pool<Types>>(_pools).size() + ...); }
+    
+    private:
+        std::tuple<object_pool<Types>...> _pools;
+    };
+    
+    void Start();
+}
+
+#endif /* Object_Pool_hpp */
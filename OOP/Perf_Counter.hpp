@@ -0,0 +1,116 @@
+#ifndef Perf_Counter_hpp
+#define Perf_Counter_hpp
+
+#include <cstdint>
+#include <optional>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ Аппаратные счетчики процессора (промахи предсказателя переходов, промахи кэша, инструкции) для замеров в примерах.
+ Linux: perf_event_open считает события только текущего потока и только в пользовательском режиме.
+ Счетчики могут быть недоступны (другая ОС, виртуальная машина без PMU, kernel.perf_event_paranoid > 2) - тогда available() == false, а замер возвращает std::nullopt.
+ */
+namespace perf_counter
+{
+    enum class Event
+    {
+        instructions,
+        branch_instructions,
+        branch_misses,   // все промахи предсказателя: условные и косвенные переходы
+        cache_misses     // промахи последнего уровня кэша
+    };
+    
+    class PerfCounter
+    {
+    public:
+        explicit PerfCounter(Event event) noexcept
+        {
+#if defined(__linux__)
+            perf_event_attr attribute;
+            std::memset(&attribute, 0, sizeof(attribute));
+            attribute.type = PERF_TYPE_HARDWARE;
+            attribute.size = sizeof(attribute);
+            attribute.config = config(event);
+            attribute.disabled = 1;
+            attribute.exclude_kernel = 1;
+            attribute.exclude_hv = 1;
+            _descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attribute, 0, -1, -1, 0));
+#else
+            (void)event;
+#endif
+        }
+        
+        ~PerfCounter()
+        {
+#if defined(__linux__)
+            if (_descriptor >= 0)
+                close(_descriptor);
+#endif
+        }
+        
+        PerfCounter(const PerfCounter&) = delete;
+        PerfCounter& operator=(const PerfCounter&) = delete;
+        
+        bool available() const noexcept { return _descriptor >= 0; }
+        
+        void start() noexcept
+        {
+#if defined(__linux__)
+            if (available())
+            {
+                ioctl(_descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+        
+        std::optional<std::uint64_t> stop() noexcept
+        {
+#if defined(__linux__)
+            std::uint64_t value = 0;
+            if (available())
+            {
+                ioctl(_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(_descriptor, &value, sizeof(value)) == sizeof(value))
+                    return value;
+            }
+#endif
+            return std::nullopt;
+        }
+        
+        /// Число событий за один вызов function
+        template <class Function>
+        std::optional<std::uint64_t> measure(Function&& function) noexcept(noexcept(function()))
+        {
+            start();
+            function();
+            return stop();
+        }
+    
+    private:
+#if defined(__linux__)
+        static std::uint64_t config(Event event) noexcept
+        {
+            switch (event)
+            {
+                case Event::instructions: return PERF_COUNT_HW_INSTRUCTIONS;
+                case Event::branch_instructions: return PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+                case Event::branch_misses: return PERF_COUNT_HW_BRANCH_MISSES;
+                case Event::cache_misses: return PERF_COUNT_HW_CACHE_MISSES;
+            }
+            return PERF_COUNT_HW_INSTRUCTIONS;
+        }
+#endif
+        
+        int _descriptor = -1;
+    };
+}
+
+#endif /* Perf_Counter_hpp */
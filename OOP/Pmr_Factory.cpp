@@ -0,0 +1,165 @@
+#include "Pmr_Factory.hpp"
+#include "Arena.hpp"
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <iostream>
+
+/*
+ Сайты: https://en.cppreference.com/w/cpp/memory/memory_resource
+        https://www.youtube.com/watch?v=q6A7cKFXjY0
+ */
+
+namespace pmr_factory
+{
+    void* CountingResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        ++_allocations;
+        _bytes += bytes;
+        return _upstream->allocate(bytes, alignment);
+    }
+    
+    void CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+    {
+        _upstream->deallocate(pointer, bytes, alignment);
+    }
+    
+    Record::Record(size_t size, allocator_type allocator) :
+    values(size, 0, allocator),
+    name("record with a name longer than small string buffer", allocator)
+    {
+    }
+    
+    Record::Record(const Record& other, allocator_type allocator) :
+    values(other.values, allocator),
+    name(other.name, allocator)
+    {
+    }
+    
+    Record::Record(Record&& other, allocator_type allocator) :
+    values(std::move(other.values), allocator),
+    name(std::move(other.name), allocator)
+    {
+    }
+    
+    namespace RVO
+    {
+        Record function(size_t size, std::pmr::memory_resource* resource)
+        {
+            return Record(size, resource);
+        }
+    }
+    
+    namespace NRVO
+    {
+        Record function(size_t size, std::pmr::memory_resource* resource)
+        {
+            Record record(size, resource);
+            record.values.back() = static_cast<int>(size);
+            return record;
+        }
+    }
+    
+    namespace NO_NRVO
+    {
+        Record function_ref(const Record& record, std::pmr::memory_resource* resource)
+        {
+            return Record(record, resource);
+        }
+    }
+    
+    namespace
+    {
+        /// Запрос: десятки временных объектов из фабрик, которые выбрасываются в конце
+        long long request(std::pmr::memory_resource* resource)
+        {
+            constexpr size_t temporaries = 32;
+            std::pmr::vector<Record> records(resource);
+            records.reserve(temporaries * 3);
+            for (size_t i = 0; i < temporaries; ++i)
+            {
+                records.push_back(RVO::function(16, resource));
+                records.push_back(NRVO::function(32, resource));
+                records.push_back(NO_NRVO::function_ref(records.back(), resource));
+            }
+            
+            long long sum = 0;
+            for (const auto& record : records)
+                sum += record.values.back() + static_cast<long long>(record.name.size());
+            return sum;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "pmr factory" << std::endl;
+        
+        /// Ловушка: копирование без аллокатора уходит в ресурс по умолчанию
+        {
+            std::byte buffer[4096];
+            std::pmr::monotonic_buffer_resource region(buffer, sizeof(buffer));
+            Record record(8, &region);
+            Record copy = record;                      // ресурс по умолчанию (new_delete_resource)
+            Record region_copy(record, &region);       // тот же регион
+            std::cout << std::boolalpha
+                      << "копия в регионе: " << (copy.get_allocator().resource() == &region)                 // false
+                      << ", копия с аллокатором в регионе: " << (region_copy.get_allocator().resource() == &region) // true
+                      << std::noboolalpha << std::endl;
+        }
+        
+        /*
+         Выделения памяти, дошедшие до кучи (upstream), и время на запрос:
+         - default: каждый vector/string - malloc и free;
+         - monotonic (стековый буфер 64 KiB): сдвиг указателя в буфере, free нет, буфер отбрасывается в конце запроса;
+         - arena потока (Arena.hpp): блоки арены переиспользуются между запросами, Scope откатывает арену в конце запроса.
+         */
+        {
+            constexpr size_t requests = 2000;
+            CountingResource heap;
+            
+            heap.reset_statistic();
+            const double default_ms = benchmark::measure_ms([&]
+            {
+                long long sum = 0;
+                for (size_t i = 0; i < requests; ++i)
+                    sum += request(&heap);
+                benchmark::do_not_optimize(sum);
+            }, 1);
+            const double default_allocations = double(heap.allocations()) / requests;
+            
+            heap.reset_statistic();
+            const double monotonic_ms = benchmark::measure_ms([&]
+            {
+                long long sum = 0;
+                for (size_t i = 0; i < requests; ++i)
+                {
+                    alignas(std::max_align_t) std::byte buffer[64 * 1024];
+                    std::pmr::monotonic_buffer_resource region(buffer, sizeof(buffer), &heap);
+                    sum += request(&region);
+                }
+                benchmark::do_not_optimize(sum);
+            }, 1);
+            const double monotonic_allocations = double(heap.allocations()) / requests;
+            
+            heap.reset_statistic();
+            arena::Arena arena(64 * 1024, &heap); // в сервере - thread_local арена на каждый поток-обработчик
+            const double arena_ms = benchmark::measure_ms([&]
+            {
+                long long sum = 0;
+                for (size_t i = 0; i < requests; ++i)
+                {
+                    arena::Arena::Scope scope(arena);
+                    sum += request(&arena);
+                }
+                benchmark::do_not_optimize(sum);
+            }, 1);
+            const double arena_allocations = double(heap.allocations()) / requests;
+            
+            std::cout << "default: " << default_allocations << " выделений/запрос, " << default_ms * 1000 / requests << " us/запрос" << std::endl;
+            std::cout << "monotonic: " << monotonic_allocations << " выделений/запрос, " << monotonic_ms * 1000 / requests << " us/запрос" << std::endl;
+            std::cout << "arena: " << arena_allocations << " выделений/запрос, " << arena_ms * 1000 / requests << " us/запрос" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
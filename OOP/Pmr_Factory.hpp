@@ -0,0 +1,75 @@
+#ifndef Pmr_Factory_hpp
+#define Pmr_Factory_hpp
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+/*
+ RVO/NRVO убирают копию самого объекта, но объект с std::vector/std::string внутри все равно обращается к куче за каждым полем.
+ pmr-фабрики принимают std::pmr::memory_resource*: все временные объекты запроса берут память из одного региона (monotonic_buffer_resource на стековом буфере или арена потока из Arena.hpp), а в конце запроса регион освобождается целиком.
+ Record - allocator-aware тип (allocator_type + конструкторы с аллокатором), поэтому std::pmr::vector<Record> сам передает свой ресурс элементам (uses-allocator construction).
+ Ловушка: обычный конструктор копирования pmr-контейнера берет ресурс по умолчанию (select_on_container_copy_construction), а не ресурс источника - для копии в регион нужен конструктор копирования с аллокатором.
+ */
+namespace pmr_factory
+{
+    /// Обертка над ресурсом: считает выделения памяти, которые дошли до upstream
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept : _upstream(upstream) {}
+        
+        size_t allocations() const noexcept { return _allocations; }
+        size_t bytes() const noexcept { return _bytes; }
+        void reset_statistic() noexcept { _allocations = _bytes = 0; }
+    
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        
+        std::pmr::memory_resource* _upstream;
+        size_t _allocations = 0;
+        size_t _bytes = 0;
+    };
+    
+    /// Аналог A из RVO&NRVO.cpp с данными в куче
+    struct Record
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+        
+        explicit Record(size_t size, allocator_type allocator = {});
+        Record(const Record& other) = default; // ресурс по умолчанию, а не ресурс other
+        Record(const Record& other, allocator_type allocator);
+        Record(Record&& other) noexcept = default;
+        Record(Record&& other, allocator_type allocator);
+        Record& operator=(const Record&) = default;
+        Record& operator=(Record&&) = default;
+        
+        allocator_type get_allocator() const noexcept { return values.get_allocator(); }
+        
+        std::pmr::vector<int> values;
+        std::pmr::string name;
+    };
+    
+    namespace RVO
+    {
+        Record function(size_t size, std::pmr::memory_resource* resource);
+    }
+    
+    namespace NRVO
+    {
+        Record function(size_t size, std::pmr::memory_resource* resource);
+    }
+    
+    namespace NO_NRVO
+    {
+        /// Копия в регион resource (а не в ресурс по умолчанию)
+        Record function_ref(const Record& record, std::pmr::memory_resource* resource);
+    }
+    
+    void Start();
+}
+
+#endif /* Pmr_Factory_hpp */
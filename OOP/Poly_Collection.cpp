@@ -0,0 +1,131 @@
+#include "Poly_Collection.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+/*
+ Сайты: https://www.boost.org/doc/libs/release/doc/html/poly_collection.html
+        https://bannalia.blogspot.com/2014/05/fast-polymorphic-collections.html
+ */
+
+namespace poly_collection
+{
+    namespace
+    {
+        /// Иерархия из Aligment.cpp (позднее связывание): маленькие объекты с vptr
+        struct Base
+        {
+            virtual ~Base() = default;
+            virtual int function(int number) const = 0;
+            
+            int number = 0;
+        };
+        
+        struct Derived1 final : Base
+        {
+            explicit Derived1(int value) { number = value; }
+            int function(int value) const override { return value + number + c; }
+            
+            char c = 1;
+        };
+        
+        struct Derived2 final : Base
+        {
+            explicit Derived2(int value) { number = value; }
+            int function(int value) const override { return value * 2 - number; }
+            
+            char c = 2;
+        };
+        
+        struct Derived3 final : Base
+        {
+            explicit Derived3(int value) { number = value; }
+            int function(int value) const override { return value ^ number; }
+            
+            double d = 3.0;
+        };
+        
+        struct Derived4 final : Base
+        {
+            explicit Derived4(int value) { number = value; }
+            int function(int value) const override { return (value + number) >> 1; }
+            
+            int values[4] = {4, 4, 4, 4};
+        };
+    }
+    
+    void Start()
+    {
+        std::cout << "poly collection" << std::endl;
+        
+        /// Объекты раскладываются по сегментам своих типов
+        {
+            poly_collection<Base> collection;
+            collection.emplace<Derived1>(1);
+            collection.emplace<Derived2>(2);
+            collection.emplace<Derived1>(3);
+            std::cout << "объектов: " << collection.size() << ", сегментов: " << collection.segments() << std::endl; // 3, 2
+            
+            collection.for_each([](const Base& base) { std::cout << base.number << " "; }); // 1 3 2 - порядок по сегментам
+            std::cout << std::endl;
+        }
+        
+        /*
+         400000 объектов четырех типов в случайном порядке:
+         - vector<unique_ptr<Base>>: объекты разбросаны по куче, тип следующего объекта случаен;
+         - poly_collection::for_each(Base&): объекты подряд, виртуальный вызов в сегменте всегда в одну функцию;
+         - poly_collection::for_each<Derived1..4>(Derived&): вызов final метода прямой и встраивается.
+         */
+        {
+            constexpr size_t count = 400'000;
+            std::vector<int> kinds(count);
+            for (size_t i = 0; i < count; ++i)
+                kinds[i] = static_cast<int>(i % 4);
+            std::shuffle(kinds.begin(), kinds.end(), std::mt19937(3));
+            
+            std::vector<std::unique_ptr<Base>> pointers;
+            poly_collection<Base> collection;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const int value = static_cast<int>(i);
+                switch (kinds[i])
+                {
+                    case 0: pointers.push_back(std::make_unique<Derived1>(value)); collection.emplace<Derived1>(value); break;
+                    case 1: pointers.push_back(std::make_unique<Derived2>(value)); collection.emplace<Derived2>(value); break;
+                    case 2: pointers.push_back(std::make_unique<Derived3>(value)); collection.emplace<Derived3>(value); break;
+                    default: pointers.push_back(std::make_unique<Derived4>(value)); collection.emplace<Derived4>(value); break;
+                }
+            }
+            
+            long long pointers_sum = 0, virtual_sum = 0, restituted_sum = 0;
+            const double pointers_ms = benchmark::measure_ms([&]
+            {
+                pointers_sum = 0;
+                for (const auto& pointer : pointers)
+                    pointers_sum += pointer->function(7);
+                benchmark::do_not_optimize(pointers_sum);
+            });
+            const double virtual_ms = benchmark::measure_ms([&]
+            {
+                virtual_sum = 0;
+                collection.for_each([&](const Base& base) { virtual_sum += base.function(7); });
+                benchmark::do_not_optimize(virtual_sum);
+            });
+            const double restituted_ms = benchmark::measure_ms([&]
+            {
+                restituted_sum = 0;
+                collection.for_each<Derived1, Derived2, Derived3, Derived4>([&](const auto& derived) { restituted_sum += derived.function(7); });
+                benchmark::do_not_optimize(restituted_sum);
+            });
+            
+            std::cout << "суммы " << (pointers_sum == virtual_sum && virtual_sum == restituted_sum ? "совпадают" : "НЕ совпадают") << std::endl;
+            std::cout << "vector<unique_ptr<Base>>: " << pointers_ms << " ms" << std::endl;
+            std::cout << "poly_collection, Base&: " << virtual_ms << " ms" << std::endl;
+            std::cout << "poly_collection, Derived& (restitution): " << restituted_ms << " ms" << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
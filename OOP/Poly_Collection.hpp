@@ -0,0 +1,139 @@
+#ifndef Poly_Collection_hpp
+#define Poly_Collection_hpp
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/*
+ poly_collection<Base> - контейнер полиморфных объектов, разложенных по сегментам: у каждого динамического типа свой непрерывный std::vector<Derived>.
+ vector<Base*> с перемешанными Derived1/Derived2 (Aligment.cpp) при обходе прыгает по куче, а каждый виртуальный вызов может уйти в другую функцию - промахи кэша данных, кэша инструкций и предсказателя переходов.
+ В poly_collection подряд идут объекты одного типа: данные читаются последовательно, а виртуальный вызов внутри сегмента всегда ведет в одну функцию.
+ for_each<Derived1, Derived2>(f) - восстановление типа (type restitution): для перечисленных типов f получает Derived&, и вызов метода final класса становится прямым и встраивается; остальные сегменты обходятся через Base&.
+ Ограничения: порядок вставки между разными типами не сохраняется, вставка может инвалидировать ссылки на объекты того же типа (рост вектора).
+ */
+namespace poly_collection
+{
+    template <class Base>
+    class poly_collection
+    {
+    public:
+        template <class Derived, class... Args>
+        Derived& emplace(Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Base, Derived>, "Derived должен наследоваться от Base");
+            return segment<Derived>().objects.emplace_back(std::forward<Args>(args)...);
+        }
+        
+        template <class Derived>
+        Derived& insert(Derived&& derived)
+        {
+            return emplace<std::decay_t<Derived>>(std::forward<Derived>(derived));
+        }
+        
+        size_t size() const noexcept
+        {
+            size_t result = 0;
+            for (const auto& segment : _segments)
+                result += segment->size();
+            return result;
+        }
+        
+        size_t segments() const noexcept { return _segments.size(); }
+        
+        void clear() noexcept { _segments.clear(); }
+        
+        /// Обход: сегменты типов Restituted получают f(Derived&), остальные - f(Base&)
+        template <class... Restituted, class Function>
+        void for_each(Function&& function)
+        {
+            for (auto& segment : _segments)
+            {
+                if (!(try_restitute<Restituted>(*segment, function) || ...))
+                    segment->for_each_base(function_ref(function));
+            }
+        }
+        
+        template <class... Restituted, class Function>
+        void for_each(Function&& function) const
+        {
+            const_cast<poly_collection&>(*this).template for_each<Restituted...>([&function](auto& object)
+            {
+                function(std::as_const(object));
+            });
+        }
+    
+    private:
+        /// Легкая ссылка на функцию для обхода через Base& (без выделения памяти, как в std::function)
+        struct FunctionRef
+        {
+            void* object;
+            void (*call)(void* object, Base& base);
+        };
+        
+        template <class Function>
+        static FunctionRef function_ref(Function& function)
+        {
+            return {std::addressof(function), [](void* object, Base& base) { (*static_cast<Function*>(object))(base); }};
+        }
+        
+        struct Segment
+        {
+            explicit Segment(std::type_index type) noexcept : type(type) {}
+            virtual ~Segment() = default;
+            virtual size_t size() const noexcept = 0;
+            virtual void for_each_base(FunctionRef function) = 0;
+            
+            std::type_index type;
+        };
+        
+        template <class Derived>
+        struct TypedSegment final : Segment
+        {
+            TypedSegment() noexcept : Segment(typeid(Derived)) {}
+            
+            size_t size() const noexcept override { return objects.size(); }
+            
+            void for_each_base(FunctionRef function) override
+            {
+                for (Derived& object : objects)
+                    function.call(function.object, object);
+            }
+            
+            std::vector<Derived> objects;
+        };
+        
+        template <class Derived>
+        TypedSegment<Derived>& segment()
+        {
+            const std::type_index type = typeid(Derived);
+            for (auto& segment : _segments) // типов обычно единицы - линейный поиск быстрее хеш-таблицы
+            {
+                if (segment->type == type)
+                    return static_cast<TypedSegment<Derived>&>(*segment);
+            }
+            _segments.push_back(std::make_unique<TypedSegment<Derived>>());
+            return static_cast<TypedSegment<Derived>&>(*_segments.back());
+        }
+        
+        template <class Derived, class Function>
+        static bool try_restitute(Segment& segment, Function& function)
+        {
+            if (segment.type != std::type_index(typeid(Derived)))
+                return false;
+            for (Derived& object : static_cast<TypedSegment<Derived>&>(segment).objects)
+                function(object);
+            return true;
+        }
+        
+        std::vector<std::unique_ptr<Segment>> _segments;
+    };
+    
+    void Start();
+}
+
+#endif /* Poly_Collection_hpp */
@@ -0,0 +1,154 @@
+#include "Poly_Value.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+ Сайты: https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2022/p3019r0.html
+        https://www.youtube.com/watch?v=QGcVXgEVMJg
+ */
+
+namespace poly_value
+{
+    namespace
+    {
+        /// Base из Virtual.cpp: virtual_destructor, вместо печати - вычисление; выделения памяти в куче считаются
+        struct Base
+        {
+            virtual ~Base() = default;
+            virtual int print(int number) const = 0;
+            
+            static void* operator new(size_t size)
+            {
+                ++allocations;
+                return ::operator new(size);
+            }
+            
+            static void operator delete(void* pointer)
+            {
+                ::operator delete(pointer);
+            }
+            
+            static inline size_t allocations = 0;
+        };
+        
+        struct Small : Base
+        {
+            explicit Small(int value) : value(value) {}
+            int print(int number) const override { return number + value; }
+            
+            int value;
+        };
+        
+        struct Medium : Base
+        {
+            explicit Medium(int value) : values{value, value, value, value} {}
+            int print(int number) const override { return number * values[0] + values[3]; }
+            
+            int values[4];
+        };
+        
+        /// Не помещается в буфер 24 байта - хранится в куче
+        struct Large : Base
+        {
+            explicit Large(int value) { std::fill(std::begin(values), std::end(values), value); }
+            int print(int number) const override { return number - values[31]; }
+            
+            int values[32];
+        };
+        
+        using Value = poly_value<Base, 24, alignof(void*)>;
+        static_assert(Value::fits_inline<Small> && Value::fits_inline<Medium> && !Value::fits_inline<Large>);
+    }
+    
+    void Start()
+    {
+        std::cout << "poly value" << std::endl;
+        
+        /// Семантика значения: копия - глубокая, без virtual clone()
+        {
+            Value first = Small(1);
+            Value second = first;
+            Value large = Large(2);
+            std::cout << "first: " << first->print(10) << ", second: " << second->print(10)
+                      << ", inline: " << first.is_inline() << " " << large.is_inline() << std::endl; // 11, 11, inline: 1 0
+        }
+        
+        /*
+         100000 объектов: 45% Small, 45% Medium, 10% Large в случайном порядке.
+         vector<unique_ptr<Base>> - выделение памяти на каждый объект и переход по указателю при обходе;
+         vector<poly_value> - выделение памяти только для Large, Small/Medium лежат в векторе подряд.
+         Здесь куча свежая и объекты unique_ptr тоже легли в память подряд - лучший случай для них; в долго работающей программе они разбросаны по куче.
+         */
+        {
+            constexpr size_t count = 100'000;
+            std::vector<int> kinds(count);
+            for (size_t i = 0; i < count; ++i)
+                kinds[i] = i % 10 == 0 ? 2 : static_cast<int>(i % 2);
+            std::shuffle(kinds.begin(), kinds.end(), std::mt19937(7));
+            
+            Base::allocations = 0;
+            benchmark::Timer pointers_timer;
+            std::vector<std::unique_ptr<Base>> pointers;
+            pointers.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const int value = static_cast<int>(i);
+                if (kinds[i] == 0)
+                    pointers.push_back(std::make_unique<Small>(value));
+                else if (kinds[i] == 1)
+                    pointers.push_back(std::make_unique<Medium>(value));
+                else
+                    pointers.push_back(std::make_unique<Large>(value));
+            }
+            const double pointers_build_ms = pointers_timer.elapsed_ms();
+            const size_t pointers_allocations = Base::allocations;
+            
+            Base::allocations = 0;
+            benchmark::Timer values_timer;
+            std::vector<Value> values;
+            values.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const int value = static_cast<int>(i);
+                if (kinds[i] == 0)
+                    values.emplace_back(std::in_place_type<Small>, value);
+                else if (kinds[i] == 1)
+                    values.emplace_back(std::in_place_type<Medium>, value);
+                else
+                    values.emplace_back(std::in_place_type<Large>, value);
+            }
+            const double values_build_ms = values_timer.elapsed_ms();
+            const size_t values_allocations = Base::allocations;
+            
+            const double pointers_iterate_ms = benchmark::measure_ms([&]
+            {
+                long long sum = 0;
+                for (const auto& pointer : pointers)
+                    sum += pointer->print(3);
+                benchmark::do_not_optimize(sum);
+            });
+            const double values_iterate_ms = benchmark::measure_ms([&]
+            {
+                long long sum = 0;
+                for (const auto& value : values)
+                    sum += value->print(3);
+                benchmark::do_not_optimize(sum);
+            });
+            
+            std::cout << "vector<unique_ptr<Base>>: выделений " << pointers_allocations << ", создание " << pointers_build_ms << " ms, обход " << pointers_iterate_ms << " ms" << std::endl;
+            std::cout << "vector<poly_value<Base, 24>>: выделений " << values_allocations << ", создание " << values_build_ms << " ms, обход " << values_iterate_ms << " ms" << std::endl;
+            
+            // Копия всего контейнера: у unique_ptr ее нет вовсе, poly_value копируется как значение
+            Base::allocations = 0;
+            std::vector<Value> copy = values;
+            std::cout << "копия vector<poly_value>: выделений " << Base::allocations << std::endl;
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef Poly_Value_hpp
+#define Poly_Value_hpp
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ poly_value<Base, N> - полиморфный объект с семантикой значения вместо Base* base = new Derived (Virtual.cpp: virtual_destructor).
+ Любой наследник Base размером до N байт хранится прямо внутри poly_value (small buffer optimization), больше - в куче.
+ Копирование, перемещение и разрушение выполняются через таблицу функций, которая генерируется для каждого Derived при создании (type erasure), поэтому:
+ - poly_value можно копировать как обычное значение (глубокая копия Derived без virtual clone()), класть в std::vector по значению;
+ - маленькие объекты не выделяют память и лежат в векторе подряд - меньше промахов кэша при обходе;
+ - разрушение вызывает ~Derived напрямую: виртуальный деструктор в Base не обязателен.
+ Вызов методов остается виртуальным: operator-> возвращает Base*.
+ */
+namespace poly_value
+{
+    template <class Base, size_t Size = 48, size_t Align = alignof(std::max_align_t)>
+    class poly_value
+    {
+    public:
+        /// Поместится ли Derived во внутренний буфер (перемещение должно быть noexcept, иначе перемещение poly_value могло бы бросить)
+        template <class Derived>
+        static constexpr bool fits_inline = sizeof(Derived) <= Size && Align % alignof(Derived) == 0 && std::is_nothrow_move_constructible_v<Derived>;
+        
+        poly_value() noexcept = default;
+        
+        template <class Derived, class... Args>
+        explicit poly_value(std::in_place_type_t<Derived>, Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Base, Derived>, "Derived должен наследоваться от Base");
+            static_assert(std::is_copy_constructible_v<Derived>, "poly_value - значение: Derived должен копироваться");
+            
+            if constexpr (fits_inline<Derived>)
+                _object = ::new (static_cast<void*>(_buffer)) Derived(std::forward<Args>(args)...);
+            else
+                _object = new Derived(std::forward<Args>(args)...);
+            _base = static_cast<Derived*>(_object);
+            _vtable = &vtable_for<Derived>;
+        }
+        
+        template <class Derived, class = std::enable_if_t<!std::is_same_v<std::decay_t<Derived>, poly_value>>>
+        poly_value(Derived&& derived) : poly_value(std::in_place_type<std::decay_t<Derived>>, std::forward<Derived>(derived)) {}
+        
+        poly_value(const poly_value& other)
+        {
+            if (other._vtable)
+                other._vtable->copy(other, *this);
+        }
+        
+        poly_value(poly_value&& other) noexcept
+        {
+            if (other._vtable)
+                other._vtable->move(other, *this);
+        }
+        
+        poly_value& operator=(const poly_value& other)
+        {
+            if (this != &other)
+            {
+                poly_value copy(other); // строгая гарантия: если копирование бросит, *this не изменится
+                reset();
+                if (copy._vtable)
+                    copy._vtable->move(copy, *this);
+            }
+            return *this;
+        }
+        
+        poly_value& operator=(poly_value&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other._vtable)
+                    other._vtable->move(other, *this);
+            }
+            return *this;
+        }
+        
+        ~poly_value()
+        {
+            reset();
+        }
+        
+        void reset() noexcept
+        {
+            if (_vtable)
+            {
+                _vtable->destroy(*this);
+                _vtable = nullptr;
+                _object = nullptr;
+                _base = nullptr;
+            }
+        }
+        
+        Base* get() noexcept { return _base; }
+        const Base* get() const noexcept { return _base; }
+        Base* operator->() noexcept { assert(_base); return _base; }
+        const Base* operator->() const noexcept { assert(_base); return _base; }
+        Base& operator*() noexcept { assert(_base); return *_base; }
+        const Base& operator*() const noexcept { assert(_base); return *_base; }
+        
+        explicit operator bool() const noexcept { return _vtable != nullptr; }
+        /// true - объект во внутреннем буфере, false - в куче
+        bool is_inline() const noexcept { return _vtable && _vtable->is_inline; }
+    
+    private:
+        struct VTable
+        {
+            void (*copy)(const poly_value& source, poly_value& target);
+            void (*move)(poly_value& source, poly_value& target) noexcept; // source становится пустым
+            void (*destroy)(poly_value& value) noexcept;
+            bool is_inline;
+        };
+        
+        template <class Derived>
+        static void copy(const poly_value& source, poly_value& target)
+        {
+            const Derived& derived = *static_cast<const Derived*>(source._object);
+            if constexpr (fits_inline<Derived>)
+                target._object = ::new (static_cast<void*>(target._buffer)) Derived(derived);
+            else
+                target._object = new Derived(derived);
+            target._base = static_cast<Derived*>(target._object);
+            target._vtable = source._vtable;
+        }
+        
+        template <class Derived>
+        static void move(poly_value& source, poly_value& target) noexcept
+        {
+            if constexpr (fits_inline<Derived>)
+            {
+                Derived* derived = static_cast<Derived*>(source._object);
+                target._object = ::new (static_cast<void*>(target._buffer)) Derived(std::move(*derived));
+                derived->~Derived();
+            }
+            else
+            {
+                target._object = source._object; // из кучи - передается указатель
+            }
+            target._base = static_cast<Derived*>(target._object);
+            target._vtable = source._vtable;
+            source._object = nullptr;
+            source._base = nullptr;
+            source._vtable = nullptr;
+        }
+        
+        template <class Derived>
+        static void destroy(poly_value& value) noexcept
+        {
+            Derived* derived = static_cast<Derived*>(value._object);
+            if constexpr (fits_inline<Derived>)
+                derived->~Derived();
+            else
+                delete derived;
+        }
+        
+        template <class Derived>
+        static constexpr VTable vtable_for = {&copy<Derived>, &move<Derived>, &destroy<Derived>, fits_inline<Derived>};
+        
+        alignas(Align) std::byte _buffer[Size];
+        void* _object = nullptr; // полный объект Derived
+        Base* _base = nullptr;   // подобъект Base (при множественном наследовании адрес может отличаться от _object)
+        const VTable* _vtable = nullptr;
+    };
+    
+    void Start();
+}
+
+#endif /* Poly_Value_hpp */
@@ -0,0 +1,134 @@
+#include "Prefetch_Dispatch.hpp"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+ Сайты: https://gcc.gnu.org/onlinedocs/gcc/Other-Builtins.html#index-_005f_005fbuiltin_005fprefetch
+        https://lwn.net/Articles/255364/
+ */
+
+namespace prefetch_dispatch
+{
+    namespace
+    {
+        constexpr size_t max_types = 32; // много типов - много vtable, которые не помещаются в одну кэш-линию
+        
+        struct Base
+        {
+            explicit Base(int data) : data(data) {}
+            virtual ~Base() = default;
+            virtual int print(int number) const = 0;
+            
+            int data;
+        };
+        
+        template <int K>
+        struct Derived final : Base
+        {
+            using Base::Base;
+            int print(int number) const override { return number * (K + 1) + data; }
+        };
+        
+        template <size_t... K>
+        std::unique_ptr<Base> make_object(size_t type, int data, std::index_sequence<K...>)
+        {
+            std::unique_ptr<Base> result;
+            (void)((type == K ? (result = std::make_unique<Derived<K>>(data), true) : false) || ...);
+            return result;
+        }
+        
+        /// Вытесняет кэши процессора: обход начинается с «холодной» кучи
+        void flush_caches()
+        {
+            static std::vector<char> buffer(64 << 20);
+            for (size_t i = 0; i < buffer.size(); i += 64)
+                buffer[i] = static_cast<char>(buffer[i] + 1);
+            benchmark::clobber_memory();
+        }
+        
+        /// Лучшее время (мс) из repeats запусков, перед каждым - вытеснение кэшей
+        template <class Function>
+        double measure_cold_ms(Function&& function, size_t repeats = 5)
+        {
+            double best = std::numeric_limits<double>::max();
+            for (size_t i = 0; i < repeats; ++i)
+            {
+                flush_caches();
+                benchmark::Timer timer;
+                function();
+                benchmark::clobber_memory();
+                best = std::min(best, timer.elapsed_ms());
+            }
+            return best;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "prefetch dispatch" << std::endl;
+        
+        /*
+         1 млн объектов 32 типов, после вытеснения кэшей:
+         - по порядку выделения: адреса растут, аппаратный prefetcher справляется сам;
+         - перемешанные указатели: каждый объект и его vtable - промахи кэша, программная предвыборка их перекрывает.
+         */
+        {
+            constexpr size_t count = 1'000'000;
+            std::mt19937 generator(23);
+            std::vector<std::unique_ptr<Base>> objects;
+            objects.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                objects.push_back(make_object(generator() % max_types, static_cast<int>(i % 1000), std::make_index_sequence<max_types>{}));
+            
+            std::vector<const Base*> ordered;
+            ordered.reserve(count);
+            for (const auto& object : objects)
+                ordered.push_back(object.get());
+            std::vector<const Base*> shuffled = ordered;
+            std::shuffle(shuffled.begin(), shuffled.end(), generator);
+            
+            for (const auto& [name, pointers] : {std::pair{"по порядку выделения", &ordered}, std::pair{"перемешанные", &shuffled}})
+            {
+                long long plain_sum = 0, batch4_sum = 0, batch8_sum = 0, batch16_sum = 0;
+                const double plain_ms = measure_cold_ms([&]
+                {
+                    plain_sum = 0;
+                    for (const Base* object : *pointers)
+                        plain_sum += object->print(7);
+                    benchmark::do_not_optimize(plain_sum);
+                });
+                const double batch4_ms = measure_cold_ms([&]
+                {
+                    batch4_sum = 0;
+                    for_each_virtual<4>(*pointers, [&](const Base& object) { batch4_sum += object.print(7); });
+                    benchmark::do_not_optimize(batch4_sum);
+                });
+                const double batch8_ms = measure_cold_ms([&]
+                {
+                    batch8_sum = 0;
+                    for_each_virtual<8>(*pointers, [&](const Base& object) { batch8_sum += object.print(7); });
+                    benchmark::do_not_optimize(batch8_sum);
+                });
+                const double batch16_ms = measure_cold_ms([&]
+                {
+                    batch16_sum = 0;
+                    for_each_virtual<16>(*pointers, [&](const Base& object) { batch16_sum += object.print(7); });
+                    benchmark::do_not_optimize(batch16_sum);
+                });
+                
+                const bool equal = plain_sum == batch4_sum && batch4_sum == batch8_sum && batch8_sum == batch16_sum;
+                std::cout << name << (equal ? "" : " (суммы НЕ совпадают)") << ": цикл " << plain_ms << " ms, for_each_virtual<4> " << batch4_ms
+                          << " ms, <8> " << batch8_ms << " ms, <16> " << batch16_ms << " ms" << std::endl;
+            }
+        }
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef Prefetch_Dispatch_hpp
+#define Prefetch_Dispatch_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH_DISPATCH_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define PREFETCH_DISPATCH_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define PREFETCH_DISPATCH_PREFETCH(address) ((void)0)
+#endif
+
+/*
+ Виртуальный вызов для каждого элемента длинного vector<Base*> ждет память 2 раза подряд: загрузку объекта (vptr) и загрузку vtable по vptr.
+ Если объекты разбросаны по куче в случайном порядке, аппаратный prefetcher адреса не угадывает, и каждый элемент - 2 последовательных промаха кэша.
+ for_each_virtual<Batch>(range, function) обходит указатели пачками по Batch элементов с программной предвыборкой (software prefetch) на 2 пачки вперед:
+ - пачка b + 2: prefetch заголовков объектов (первая кэш-линия, где лежит vptr);
+ - пачка b + 1: объекты уже в кэше - читается vptr и prefetch кэш-линии vtable;
+ - пачка b: вызовы function(object) идут по данным, уже лежащим в кэше.
+ Если объекты лежат по порядку адресов, аппаратный prefetcher справляется сам, и лишние инструкции предвыборки только замедляют обход.
+ vptr в первом слове объекта - так в Itanium ABI (GCC, Clang) и MSVC для одиночного наследования. Чтение vptr (detail::vptr) - настоящая загрузка первого слова объекта, поэтому элементы должны быть полиморфными;
+ при другой раскладке прочитанное слово не будет адресом vtable, но prefetch по нему - только подсказка процессору: ненужная линия загрузится, ошибки не будет.
+ */
+namespace prefetch_dispatch
+{
+    namespace detail
+    {
+        template <class Pointer>
+        const void* address(const Pointer& pointer) noexcept
+        {
+            return static_cast<const void*>(std::to_address(pointer));
+        }
+        
+        /// vptr из первого слова объекта (побайтовое копирование - без нарушения strict aliasing)
+        inline const void* vptr(const void* object) noexcept
+        {
+            const void* result;
+            std::memcpy(&result, object, sizeof(result));
+            return result;
+        }
+    }
+    
+    /// function(*pointer) для каждого указателя range (сырые или умные указатели) с предвыборкой объектов и vtable
+    template <size_t Batch = 8, std::ranges::random_access_range Range, class Function>
+    void for_each_virtual(Range&& range, Function&& function)
+    {
+        static_assert(Batch > 0, "Batch > 0");
+        using Object = std::remove_cvref_t<decltype(*std::declval<std::ranges::range_reference_t<Range>>())>;
+        static_assert(std::is_polymorphic_v<Object>, "элементы должны указывать на полиморфные объекты: первое слово объекта читается как vptr");
+        
+        const auto first = std::ranges::begin(range);
+        const size_t size = static_cast<size_t>(std::ranges::distance(range));
+        
+        // Разгон: объекты первых 2 пачек и vtable первой пачки
+        for (size_t i = 0; i < std::min(size, 2 * Batch); ++i)
+            PREFETCH_DISPATCH_PREFETCH(detail::address(first[i]));
+        for (size_t i = 0; i < std::min(size, Batch); ++i)
+            PREFETCH_DISPATCH_PREFETCH(detail::vptr(detail::address(first[i])));
+        
+        for (size_t batch = 0; batch < size; batch += Batch)
+        {
+            const size_t end = std::min(size, batch + Batch);
+            
+            const size_t objects_end = std::min(size, end + 2 * Batch);
+            for (size_t i = end + Batch; i < objects_end; ++i)
+                PREFETCH_DISPATCH_PREFETCH(detail::address(first[i]));
+            
+            const size_t vtables_end = std::min(size, end + Batch);
+            for (size_t i = end; i < vtables_end; ++i)
+                PREFETCH_DISPATCH_PREFETCH(detail::vptr(detail::address(first[i])));
+            
+            for (size_t i = batch; i < end; ++i)
+                function(*first[i]);
+        }
+    }
+    
+    void Start();
+}
+
+#endif /* Prefetch_Dispatch_hpp */
@@ -1,4 +1,6 @@
 #include "RVO&NRVO.hpp"
+#include "Lifetime_Probe.hpp"
+#include "Noexcept_Audit.hpp"
 
 #include <iostream>
 
@@ -6,17 +8,21 @@
  Сайты: https://habr.com/ru/companies/vk/articles/666330/
  */
 
-class A
+/*
+ Вместо печати в std::cout на каждое событие класс A считает вызовы своих специальных методов в LifetimeProbe<A>, а пример печатает разницу счетчиков.
+ Копирующий/перемещающий конструкторы и деструктор A сгенерированы компилятором и вызывают соответствующие методы LifetimeProbe.
+ */
+class A : public lifetime_probe::LifetimeProbe<A>
 {
 public:
-    A() { std::cout << "constructor" << std::endl; }
-    A(int number) { std::cout << "constructor int" << std::endl; }
-    explicit A(double number) { std::cout << "constructor doule" << std::endl; }
-    A(const A&) { std::cout << "copy constructor" << std::endl; }
-    A(A&&) noexcept { std::cout << "move constructor" << std::endl; }
-    ~A() { std::cout << "destructor" << std::endl; }
+    A() = default;
+    A([[maybe_unused]] int number) {}
+    explicit A([[maybe_unused]] double number) {}
 };
 
+/// Аудит noexcept перемещения (Noexcept_Audit.hpp): типы попадают в общий отчет
+NOEXCEPT_AUDIT(A);
+
 namespace RVO
 {
     A function()
@@ -91,22 +97,20 @@ namespace RVO_NRVO
             /// 1 Пример
             {
                 std::cout << "1 Пример" << std::endl;
-                [[maybe_unused]] auto result = function();
+                A::Scope scope;
+                {
+                    [[maybe_unused]] auto result = function();
+                }
+                std::cout << scope.diff() << std::endl;
                 
                 /*
                  Выведет с RVO:
-                 constructor
-                 destructor
+                 constructor: 1, copy constructor: 0, move constructor: 0, copy assignment: 0, move assignment: 0, destructor: 1
                  */
                  
                 /*
                  Выведет без RVO:
-                 constructor
-                 constructor copy
-                 destructor
-                 constructor copy
-                 destructor
-                 destructor
+                 constructor: 1, copy constructor: 0, move constructor: 2, copy assignment: 0, move assignment: 0, destructor: 3
                  */
             }
             std::cout << std::endl;
@@ -114,22 +118,20 @@ namespace RVO_NRVO
             {
                 std::cout << "2 Пример" << std::endl;
                 
-                [[maybe_unused]] auto result = function_int();
+                A::Scope scope;
+                {
+                    [[maybe_unused]] auto result = function_int();
+                }
+                std::cout << scope.diff() << std::endl;
                 
                 /*
                  Выведет с RVO:
-                 constructor number
-                 destructor
+                 constructor: 1, copy constructor: 0, move constructor: 0, copy assignment: 0, move assignment: 0, destructor: 1
                  */
                  
                 /*
                  Выведет без RVO:
-                 constructor number
-                 constructor copy
-                 destructor
-                 constructor copy
-                 destructor
-                 destructor
+                 constructor: 1, copy constructor: 0, move constructor: 2, copy assignment: 0, move assignment: 0, destructor: 3
                  */
             }
             std::cout << std::endl;
@@ -157,20 +159,20 @@ namespace RVO_NRVO
                 {
                     std::cout << "1 Пример" << std::endl;
                     
-                    [[maybe_unused]] auto result = function();
+                    A::Scope scope;
+                    {
+                        [[maybe_unused]] auto result = function();
+                    }
+                    std::cout << scope.diff() << std::endl;
                     
                     /*
                      Выведет с NRVO:
-                     constructor
-                     destructor
+                     constructor: 1, copy constructor: 0, move constructor: 0, copy assignment: 0, move assignment: 0, destructor: 1
                      */
                      
                     /*
                      Выведет без NRVO:
-                     constructor
-                     constructor copy
-                     destructor
-                     destructor
+                     constructor: 1, copy constructor: 0, move constructor: 1, copy assignment: 0, move assignment: 0, destructor: 2
                      */
                 }
                 std::cout << std::endl;
@@ -178,20 +180,20 @@ namespace RVO_NRVO
                 {
                     std::cout << "2 Пример: использовать std::move - нет стоит, иначе компилятор не сможет применить NRVO" << std::endl;
                     
-                    [[maybe_unused]] auto result = function_move();
+                    A::Scope scope;
+                    {
+                        [[maybe_unused]] auto result = function_move();
+                    }
+                    std::cout << scope.diff() << std::endl;
                     
                     /*
                      Выведет без NRVO:
-                     constructor
-                     constructor move
-                     destructor
-                     destructor
+                     constructor: 1, copy constructor: 0, move constructor: 1, copy assignment: 0, move assignment: 0, destructor: 2
                      */
                     
                     /*
                      Выведет с NRVO:
-                     constructor
-                     destructor
+                     constructor: 1, copy constructor: 0, move constructor: 0, copy assignment: 0, move assignment: 0, destructor: 1
                      */
                 }
             }
@@ -204,16 +206,15 @@ namespace RVO_NRVO
                 {
                     std::cout << "1 Пример" << std::endl;
                     
-                    A a;
-                    [[maybe_unused]] auto result = function(a);
+                    A::Scope scope;
+                    {
+                        A a;
+                        [[maybe_unused]] auto result = function(a);
+                    }
+                    std::cout << scope.diff() << std::endl;
                     
                     /*
-                     constructor
-                     copy constructor
-                     move constructor
-                     destructor
-                     destructor
-                     destructor
+                     constructor: 1, copy constructor: 1, move constructor: 1, copy assignment: 0, move assignment: 0, destructor: 3
                      */
                 }
                 std::cout << std::endl;
@@ -221,14 +222,15 @@ namespace RVO_NRVO
                 {
                     std::cout << "2 Пример" << std::endl;
                     
-                    A a;
-                    [[maybe_unused]] auto result = function_ref(a);
+                    A::Scope scope;
+                    {
+                        A a;
+                        [[maybe_unused]] auto result = function_ref(a);
+                    }
+                    std::cout << scope.diff() << std::endl;
                     
                     /*
-                     constructor
-                     copy constructor
-                     destructor
-                     destructor
+                     constructor: 1, copy constructor: 1, move constructor: 0, copy assignment: 0, move assignment: 0, destructor: 2
                      */
                 }
                 std::cout << std::endl;
@@ -0,0 +1,118 @@
+#include "Radix_Sort.hpp"
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+/*
+ Сайты: https://ru.wikipedia.org/wiki/%D0%9F%D0%BE%D1%80%D0%B0%D0%B7%D1%80%D1%8F%D0%B4%D0%BD%D0%B0%D1%8F_%D1%81%D0%BE%D1%80%D1%82%D0%B8%D1%80%D0%BE%D0%B2%D0%BA%D0%B0
+        https://habr.com/ru/articles/533206/
+ */
+
+namespace radix_sort
+{
+    namespace
+    {
+        /// Padding из Aligment.cpp: 16 байт, ключ number1 по смещению 4
+        struct Padding
+        {
+            char c1;
+            std::int32_t number1;
+            char c2;
+            char c3;
+            std::int32_t number2;
+        };
+        
+        /// Запись с ключами разной ширины
+        struct Record
+        {
+            std::uint64_t key64;
+            std::uint32_t key32;
+            std::uint16_t key16;
+            std::uint8_t key8;
+            std::uint8_t flags;
+            std::uint64_t payload[2];
+        };
+        
+        template <class Projection>
+        void compare(const char* name, const std::vector<Record>& records, Projection projection, const Options& options)
+        {
+            auto less = [&](const Record& lhs, const Record& rhs) { return projection(lhs) < projection(rhs); };
+            
+            auto copy = records;
+            const double std_sort = benchmark::measure_ms([&] { copy = records; std::sort(copy.begin(), copy.end(), less); }, 3);
+            const double std_stable_sort = benchmark::measure_ms([&] { copy = records; std::stable_sort(copy.begin(), copy.end(), less); }, 3);
+            const auto expected = copy;
+            const double radix = benchmark::measure_ms([&] { copy = records; sort(copy, projection); }, 3);
+            const bool stable = std::equal(copy.begin(), copy.end(), expected.begin(), [](const Record& lhs, const Record& rhs)
+            {
+                return std::memcmp(&lhs, &rhs, sizeof(Record)) == 0;
+            });
+            const double radix_parallel = benchmark::measure_ms([&] { copy = records; sort(copy, projection, options); }, 3);
+            const double copy_only = benchmark::measure_ms([&] { copy = records; }, 3); // вычитается из всех замеров
+            
+            std::cout << std::setw(8) << name << std::setw(14) << std_sort - copy_only << std::setw(18) << std_stable_sort - copy_only
+                      << std::setw(12) << radix - copy_only << std::setw(18) << radix_parallel - copy_only
+                      << std::setw(10) << (stable ? "OK" : "FAIL") << std::endl;
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "radix sort" << std::endl;
+        
+        std::mt19937_64 random(42);
+        
+        /// Ключ по смещению поля: offsetof(Padding, number1), знаковый int
+        {
+            std::vector<Padding> paddings(10);
+            for (auto& padding : paddings)
+                padding = Padding{'a', static_cast<std::int32_t>(random() % 200) - 100, 'b', 'c', 0};
+            sort_by_offset<std::int32_t>(paddings, offsetof(Padding, number1));
+            
+            std::cout << "Padding::number1:";
+            for (const auto& padding : paddings)
+                std::cout << " " << padding.number1;
+            std::cout << std::endl;
+        }
+        
+        /// Сортировка индексов: записи остаются на месте
+        {
+            std::vector<Padding> paddings(5);
+            for (auto& padding : paddings)
+                padding.number2 = static_cast<std::int32_t>(random() % 100);
+            const auto indices = sort_indices(paddings, [](const Padding& padding) { return padding.number2; });
+            
+            std::cout << "Индексы по Padding::number2:";
+            for (const auto index : indices)
+                std::cout << " " << index << "(" << paddings[index].number2 << ")";
+            std::cout << std::endl;
+        }
+        
+        /*
+         Время (мс) сортировки 1e6 записей по 32 байта в зависимости от ширины ключа.
+         Radix sort делает sizeof(key) проходов, поэтому выигрыш максимален на узких ключах; std::sort - O(n log n) сравнений независимо от ширины.
+         */
+        {
+            constexpr size_t count = 1'000'000;
+            std::vector<Record> records(count);
+            for (auto& record : records)
+            {
+                const auto value = random();
+                record = Record{value, static_cast<std::uint32_t>(value >> 7), static_cast<std::uint16_t>(value >> 13), static_cast<std::uint8_t>(value >> 29), 0, {value, 0}};
+            }
+            
+            const Options options{std::max<size_t>(1, std::thread::hardware_concurrency())};
+            std::cout << std::setw(8) << "key" << std::setw(14) << "std::sort" << std::setw(18) << "std::stable_sort"
+                      << std::setw(12) << "radix" << std::setw(18) << "radix x" + std::to_string(options.threads) << std::setw(10) << "stable" << std::endl;
+            compare("8 bit", records, [](const Record& record) { return record.key8; }, options);
+            compare("16 bit", records, [](const Record& record) { return record.key16; }, options);
+            compare("32 bit", records, [](const Record& record) { return record.key32; }, options);
+            compare("64 bit", records, [](const Record& record) { return record.key64; }, options);
+        }
+        
+        std::cout << std::endl;
+    }
+}
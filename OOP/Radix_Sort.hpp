@@ -0,0 +1,199 @@
+#ifndef Radix_Sort_hpp
+#define Radix_Sort_hpp
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RADIX_SORT_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define RADIX_SORT_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define RADIX_SORT_PREFETCH(address) ((void)0)
+#endif
+
+/*
+ LSD (least significant digit) radix sort - поразрядная сортировка от младшего байта ключа к старшему.
+ Каждый проход - устойчивое распределение по 256 корзинам, поэтому вся сортировка устойчива (как std::stable_sort) и выполняется за O(n * sizeof(key)) без сравнений.
+ Гистограммы всех разрядов считаются за один проход чтения; проход, в котором все ключи попали в одну корзину, пропускается.
+ Ключ задается проекцией (лямбда от записи) или смещением поля (offsetof из Aligment.cpp) - удобно для POD записей, которые можно копировать побайтово.
+ */
+namespace radix_sort
+{
+    struct Options
+    {
+        size_t threads = 1; // > 1: гистограммы считаются параллельно по частям массива
+    };
+    
+    namespace detail
+    {
+        constexpr size_t prefetch_distance = 16;
+        constexpr size_t parallel_threshold = 1 << 16; // меньше элементов на поток - потоки дороже выигрыша
+        
+        template <class Key>
+        using unsigned_key_t = std::make_unsigned_t<Key>;
+        
+        /// Знаковые ключи: инверсия старшего бита переводит порядок в беззнаковый
+        template <class Key>
+        unsigned_key_t<Key> to_unsigned(Key key) noexcept
+        {
+            using Unsigned = unsigned_key_t<Key>;
+            if constexpr (std::is_signed_v<Key>)
+                return static_cast<Unsigned>(static_cast<Unsigned>(key) ^ (Unsigned(1) << (sizeof(Key) * 8 - 1)));
+            else
+                return key;
+        }
+        
+        template <class Unsigned>
+        using Histograms = std::array<std::array<size_t, 256>, sizeof(Unsigned)>;
+        
+        template <class Unsigned, class T, class Projection>
+        void count(const T* first, const T* last, Projection& projection, Histograms<Unsigned>& histograms)
+        {
+            for (const T* it = first; it != last; ++it) // последовательное чтение: аппаратный prefetcher справляется сам
+            {
+                const Unsigned key = to_unsigned(std::invoke(projection, *it));
+                for (size_t pass = 0; pass < sizeof(Unsigned); ++pass)
+                    ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+            }
+        }
+        
+        template <class Unsigned, class T, class Projection>
+        Histograms<Unsigned> histograms(const T* data, size_t size, Projection& projection, size_t threads)
+        {
+            Histograms<Unsigned> result{};
+            threads = std::min(threads, size / parallel_threshold);
+            if (threads <= 1)
+            {
+                count<Unsigned>(data, data + size, projection, result);
+                return result;
+            }
+            
+            // Каждый поток считает свою часть в свои гистограммы, затем они складываются
+            std::vector<Histograms<Unsigned>> partial(threads);
+            std::vector<std::thread> workers;
+            const size_t chunk = (size + threads - 1) / threads;
+            for (size_t i = 0; i < threads; ++i)
+            {
+                const T* first = data + std::min(size, i * chunk);
+                const T* last = data + std::min(size, (i + 1) * chunk);
+                workers.emplace_back([&, first, last, i] { count<Unsigned>(first, last, projection, partial[i]); });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            
+            for (const auto& local : partial)
+                for (size_t pass = 0; pass < sizeof(Unsigned); ++pass)
+                    for (size_t digit = 0; digit < 256; ++digit)
+                        result[pass][digit] += local[pass][digit];
+            return result;
+        }
+        
+        template <class T, class Projection>
+        void sort(T* data, size_t size, Projection projection, const Options& options)
+        {
+            using Key = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<Projection&, const T&>>>;
+            static_assert(std::is_integral_v<Key>, "ключ radix sort должен быть целым числом");
+            using Unsigned = unsigned_key_t<Key>;
+            
+            if (size < 2)
+                return;
+            
+            auto counts = histograms<Unsigned>(data, size, projection, options.threads);
+            std::unique_ptr<T[]> buffer(new T[size]); // без обнуления: все элементы будут перезаписаны
+            T* source = data;
+            T* target = buffer.get();
+            
+            for (size_t pass = 0; pass < sizeof(Unsigned); ++pass)
+            {
+                auto& histogram = counts[pass];
+                // Все ключи в одной корзине - проход ничего не поменяет
+                if (std::any_of(histogram.begin(), histogram.end(), [size](size_t number) { return number == size; }))
+                    continue;
+                
+                size_t offset = 0;
+                for (auto& number : histogram)
+                {
+                    const size_t current = number;
+                    number = offset;
+                    offset += current;
+                }
+                
+                const size_t shift = pass * 8;
+                auto digit_of = [&](size_t i) { return (to_unsigned(std::invoke(projection, source[i])) >> shift) & 0xFF; };
+                for (size_t i = 0; i < size; ++i)
+                {
+                    // Запись идет в 256 разных мест: заранее загружается ячейка назначения элемента, до которого дойдем через prefetch_distance шагов
+                    if (i + prefetch_distance < size)
+                        RADIX_SORT_PREFETCH(&target[histogram[digit_of(i + prefetch_distance)]]);
+                    target[histogram[digit_of(i)]++] = source[i];
+                }
+                std::swap(source, target);
+            }
+            
+            if (source != data)
+                std::copy(source, source + size, data);
+        }
+    }
+    
+    /// Устойчивая сортировка записей по целочисленному ключу projection(record)
+    template <class T, class Projection>
+    void sort(T* first, T* last, Projection projection, const Options& options = {})
+    {
+        detail::sort(first, static_cast<size_t>(last - first), std::move(projection), options);
+    }
+    
+    template <class T, class Projection>
+    void sort(std::vector<T>& records, Projection projection, const Options& options = {})
+    {
+        detail::sort(records.data(), records.size(), std::move(projection), options);
+    }
+    
+    /// Ключ - поле типа Key по смещению offset (например, offsetof(Record, id))
+    template <class Key, class T>
+    void sort_by_offset(std::vector<T>& records, size_t offset, const Options& options = {})
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "ключ читается побайтово: запись должна быть trivially copyable");
+        detail::sort(records.data(), records.size(), [offset](const T& record)
+        {
+            Key key;
+            std::memcpy(&key, reinterpret_cast<const char*>(&record) + offset, sizeof(Key));
+            return key;
+        }, options);
+    }
+    
+    /// Сортирует не записи, а их индексы: большие записи не перемещаются
+    template <class T, class Projection>
+    std::vector<std::uint32_t> sort_indices(const std::vector<T>& records, Projection projection, const Options& options = {})
+    {
+        using Key = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<Projection&, const T&>>>;
+        struct Entry
+        {
+            Key key;
+            std::uint32_t index;
+        };
+        
+        std::vector<Entry> entries(records.size());
+        for (size_t i = 0; i < records.size(); ++i)
+            entries[i] = Entry{std::invoke(projection, records[i]), static_cast<std::uint32_t>(i)};
+        detail::sort(entries.data(), entries.size(), [](const Entry& entry) { return entry.key; }, options);
+        
+        std::vector<std::uint32_t> indices(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i)
+            indices[i] = entries[i].index;
+        return indices;
+    }
+    
+    void Start();
+}
+
+#endif /* Radix_Sort_hpp */
@@ -0,0 +1,138 @@
+#include "Sink_Parameters.hpp"
+#include "Benchmark.hpp"
+#include "Lifetime_Probe.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+ Сайты: https://isocpp.github.io/CppCoreGuidelines/CppCoreGuidelines#f18-for-will-move-from-parameters-pass-by-x-and-stdmove-the-parameter
+        https://www.youtube.com/watch?v=xnqTKD8uD64
+ */
+
+namespace sink_parameters
+{
+    namespace
+    {
+        enum class Caller
+        {
+            lvalue,
+            rvalue
+        };
+        
+        struct Result
+        {
+            double ns = std::numeric_limits<double>::max();
+            double copies = 0;
+            double moves = 0;
+        };
+        
+        /// operation(sources[i]) - один вызов; источники готовятся заранее и в замер не входят
+        template <class T, class Operation>
+        Result run(const T& prototype, Operation&& operation)
+        {
+            constexpr size_t calls = 2000;
+            constexpr size_t repeats = 3;
+            
+            Result result;
+            for (size_t repeat = 0; repeat < repeats; ++repeat)
+            {
+                std::vector<T> sources(calls, prototype);
+                typename T::Scope scope;
+                benchmark::Timer timer;
+                for (auto& source : sources)
+                    operation(source);
+                benchmark::clobber_memory();
+                result.ns = std::min(result.ns, timer.elapsed_ns() / double(calls));
+                
+                const auto diff = scope.diff();
+                result.copies = double(diff.copies()) / double(calls);
+                result.moves = double(diff.moves()) / double(calls);
+            }
+            return result;
+        }
+        
+        template <template <class> class Sink, class T>
+        Result construct(const T& prototype, Caller caller)
+        {
+            return run(prototype, [caller](T& source)
+            {
+                if (caller == Caller::lvalue)
+                {
+                    Sink<T> sink(source);
+                    benchmark::do_not_optimize(sink);
+                }
+                else
+                {
+                    Sink<T> sink(std::move(source));
+                    benchmark::do_not_optimize(sink);
+                }
+            });
+        }
+        
+        template <template <class> class Sink, class T>
+        Result set(const T& prototype, Caller caller)
+        {
+            Sink<T> sink(prototype); // в поле уже есть память нужного размера
+            return run(prototype, [&sink, caller](T& source)
+            {
+                if (caller == Caller::lvalue)
+                    sink.set(source);
+                else
+                    sink.set(std::move(source));
+                benchmark::do_not_optimize(sink);
+            });
+        }
+        
+        void print(const char* payload, const char* sink, const char* operation, Caller caller, const Result& result)
+        {
+            std::cout << std::left << std::setw(20) << payload << std::setw(12) << sink << std::setw(12) << operation
+                      << std::setw(8) << (caller == Caller::lvalue ? "lvalue" : "rvalue")
+                      << std::right << std::fixed << std::setprecision(1) << std::setw(10) << result.ns
+                      << std::setprecision(2) << std::setw(10) << result.copies << std::setw(10) << result.moves << std::endl;
+        }
+        
+        template <class T>
+        void benchmark_payload(const char* payload, const T& prototype)
+        {
+            for (Caller caller : {Caller::lvalue, Caller::rvalue})
+            {
+                print(payload, "ByValue", "construct", caller, construct<ByValue>(prototype, caller));
+                print(payload, "Overloads", "construct", caller, construct<Overloads>(prototype, caller));
+                print(payload, "Forwarding", "construct", caller, construct<Forwarding>(prototype, caller));
+                print(payload, "ByValue", "set", caller, set<ByValue>(prototype, caller));
+                print(payload, "Overloads", "set", caller, set<Overloads>(prototype, caller));
+                print(payload, "Forwarding", "set", caller, set<Forwarding>(prototype, caller));
+            }
+        }
+    }
+    
+    void Start()
+    {
+        std::cout << "sink parameters" << std::endl;
+        
+        /*
+         Ожидаемые копирования/перемещения на вызов:
+                              lvalue             rvalue
+         ByValue construct:   copy 1, move 1     move 2
+         Overloads construct: copy 1             move 1
+         ByValue set:         copy 1, move 1     move 2     (копия строится заново - новое выделение памяти)
+         Overloads set:       copy 1             move 1     (копирующее присваивание переиспользует память поля)
+         Forwarding - как Overloads.
+         Короткая строка (SSO) хранится внутри объекта: перемещение стоит как копирование, поэтому лишнее перемещение ByValue не бесплатно.
+         */
+        std::cout << std::left << std::setw(20) << "payload" << std::setw(12) << "sink" << std::setw(12) << "operation" << std::setw(8) << "caller"
+                  << std::right << std::setw(10) << "ns/call" << std::setw(10) << "copy" << std::setw(10) << "move" << std::endl;
+        benchmark_payload("vector<int>(1000)", lifetime_probe::Probed<std::vector<int>>(1000, 7));
+        benchmark_payload("string(1000)", lifetime_probe::Probed<std::string>(1000, 'x'));
+        benchmark_payload("string(10) SSO", lifetime_probe::Probed<std::string>(10, 'x'));
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+        
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef Sink_Parameters_hpp
+#define Sink_Parameters_hpp
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+/*
+ Sink-параметр - аргумент, который функция сохраняет у себя (в поле класса, в контейнер). Три способа его принять:
+ - по значению + std::move (ByValue): одна сигнатура; lvalue - копия + перемещение, rvalue - два перемещения.
+   Но в set() копия всегда строится заново, даже если в поле уже есть выделенная память нужного размера.
+ - пара перегрузок const& / && (Overloads): lvalue - одна копия (в set() - копирующее присваивание, которое переиспользует память поля), rvalue - одно перемещение.
+   Минимум операций, но на N параметров нужно 2^N перегрузок.
+ - шаблон с идеальной передачей U&& + std::forward (Forwarding): столько же операций, что у перегрузок, одна сигнатура,
+   но тело в заголовке, аргумент может быть любым типом, из которого строится T (нужно ограничение requires), и хуже сообщения об ошибках.
+ Вывод: для конструкторов, которые всегда создают новое поле, достаточно по значению; для set() c дорогим копированием - перегрузки или шаблон.
+ */
+namespace sink_parameters
+{
+    template <class T>
+    class ByValue
+    {
+    public:
+        explicit ByValue(T value) : _value(std::move(value)) {}
+        
+        void set(T value) { _value = std::move(value); }
+        const T& get() const noexcept { return _value; }
+    
+    private:
+        T _value;
+    };
+    
+    template <class T>
+    class Overloads
+    {
+    public:
+        explicit Overloads(const T& value) : _value(value) {}
+        explicit Overloads(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) : _value(std::move(value)) {}
+        
+        void set(const T& value) { _value = value; }
+        void set(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>) { _value = std::move(value); }
+        const T& get() const noexcept { return _value; }
+    
+    private:
+        T _value;
+    };
+    
+    template <class T>
+    class Forwarding
+    {
+    public:
+        /// Ограничение не дает шаблону перехватить копирование самого Forwarding
+        template <class U>
+        requires (!std::is_same_v<std::remove_cvref_t<U>, Forwarding> && std::constructible_from<T, U>)
+        explicit Forwarding(U&& value) : _value(std::forward<U>(value)) {}
+        
+        template <class U>
+        requires std::assignable_from<T&, U>
+        void set(U&& value) { _value = std::forward<U>(value); }
+        const T& get() const noexcept { return _value; }
+    
+    private:
+        T _value;
+    };
+    
+    void Start();
+}
+
+#endif /* Sink_Parameters_hpp */
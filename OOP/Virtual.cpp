@@ -1,6 +1,9 @@
 #include "Virtual.hpp"
+#include "Noexcept_Audit.hpp"
+#include "NVI_Instrumentation.hpp"
 
 #include <iostream>
+#include <memory>
 
 /*
  Сайты: https://forum.shelek.ru/index.php/topic,9064.0.html
@@ -138,6 +141,7 @@ namespace non_virtual_interface
         
         void print()
         {
+            NVI_PROBE(*this); // счетчик вызовов по динамическому типу (только при сборке с NVI_INSTRUMENTATION)
             print_impl();
         }
         
@@ -277,6 +281,22 @@ namespace virtual_destructor
 }
 
 
+/// Аудит noexcept перемещения (Noexcept_Audit.hpp): типы попадают в общий отчет
+NOEXCEPT_AUDIT(print::no_virtual_method::Base);
+NOEXCEPT_AUDIT(print::no_virtual_method::Derived);
+NOEXCEPT_AUDIT(print::virtual_method::Base);
+NOEXCEPT_AUDIT(print::virtual_method::Derived);
+NOEXCEPT_AUDIT(print::virtual_destructor::Base);
+NOEXCEPT_AUDIT(print::virtual_destructor::Derived);
+NOEXCEPT_AUDIT(non_virtual_interface::Base);
+NOEXCEPT_AUDIT(non_virtual_interface::Derived);
+NOEXCEPT_AUDIT(virtual_method_no_override::Base);
+NOEXCEPT_AUDIT(virtual_method_no_override::Derived);
+NOEXCEPT_AUDIT(no_virtual_destructor::Base);
+NOEXCEPT_AUDIT(no_virtual_destructor::Derived);
+NOEXCEPT_AUDIT(virtual_destructor::Base);
+NOEXCEPT_AUDIT(virtual_destructor::Derived);
+
 namespace Virtual
 {
     void Start()
@@ -414,6 +434,7 @@ namespace Virtual
              3 Способ: NVI (non virtual interface) - шаблона невиртуального интерфейса использует public невиртуальные методы в качестве обертки над вызовами private/protected виртуальных методов. NVI - частный случай паттерна — «Шаблонный метод». Преимущество идиомы NVI - выполнение предварительных действий перед вызовов виртуального метода и выполнение завершающих действий после вызова виртуального метода (например, захват mutex).
              Плюсы:
              - базовый класс (интерфейс) имеет больше контроля над своим поведением, чем производные классы (например, вывод в файл или экран не нужно дублировать в каждой реализации производного класса: достаточно вынести вызов виртуального метода в невиртуальный метод + дополнив его).
+             - единственная точка входа в виртуальный метод - место для инструментирования: NVI_PROBE (NVI_Instrumentation.hpp) считает вызовы и выборочно замеряет время по динамическому типу.
              Минусы:
              - лишние методы.
              */
@@ -8,6 +8,30 @@
 #include "POD.hpp"
 #include "RVO&NRVO.hpp"
 #include "Virtual.hpp"
+#include "Checkpoint.hpp"
+#include "Arena.hpp"
+#include "Flat_Hash_Map.hpp"
+#include "Radix_Sort.hpp"
+#include "Async_Writer.hpp"
+#include "Copy_Elision.hpp"
+#include "Must_Elide.hpp"
+#include "Sink_Parameters.hpp"
+#include "Expression_Templates.hpp"
+#include "Noexcept_Audit.hpp"
+#include "Cow.hpp"
+#include "Generator.hpp"
+#include "Pmr_Factory.hpp"
+#include "Dispatch.hpp"
+#include "Poly_Value.hpp"
+#include "Poly_Collection.hpp"
+#include "External_Polymorphism.hpp"
+#include "Closed_Hierarchy.hpp"
+#include "NVI_Instrumentation.hpp"
+#include "Inline_Cache.hpp"
+#include "Object_Pool.hpp"
+#include "Intrusive_Ptr.hpp"
+#include "Epoch_Reclamation.hpp"
+#include "Prefetch_Dispatch.hpp"
 
 #include <iostream>
 #include <vector>
@@ -422,4 +446,148 @@ int main()
     {
         RVO_NRVO::Start();
     }
+    /*
+     Checkpoint - инкрементальный снимок больших массивов POD: в файл пишутся только страницы памяти, измененные после предыдущего снимка (mprotect + SIGSEGV/SIGBUS на Linux/macOS, GetWriteWatch на Windows).
+     */
+    {
+        checkpoint::Start();
+    }
+    /*
+     Arena (регион) - bump-выделение памяти с освобождением всех объектов за O(1) через reset()/Scope. Типы с нетривиальным деструктором допускаются только с зарегистрированным финализатором. Подходит как std::pmr::memory_resource.
+     */
+    {
+        arena::Start();
+    }
+    /*
+     Swiss table - хеш-таблица с открытой адресацией и группами управляющих байт, которые проверяются одной SSE2/AVX2 инструкцией. Ключи со стандартным устройством без padding хешируются и сравниваются побайтово.
+     */
+    {
+        flat_hash_map::Start();
+    }
+    /*
+     Radix sort (LSD) - устойчивая поразрядная сортировка POD записей по целочисленному ключу (проекция или смещение поля) без сравнений: O(n * sizeof(key)).
+     */
+    {
+        radix_sort::Start();
+    }
+    /*
+     Асинхронная запись POD записей: пачки копируются в большие выровненные буферы, которые пишутся в фоне через io_uring (Linux) или пул потоков с pwrite. Буферов ограниченное число - при их нехватке write() ждет (back-pressure).
+     */
+    {
+        async_writer::Start();
+    }
+    /*
+     Copy elision - замер шаблонов RVO/NRVO с полезной нагрузкой от 16 B до 1 MiB: время, выделения памяти, копирования и перемещения на вызов. Сборка с -fno-elide-constructors отключает NRVO - сравнить две сборки.
+     */
+    {
+        copy_elision::Start();
+    }
+    /*
+     must_elide<Factory, T>() - проверка на этапе компиляции, что фабрика возвращает prvalue (гарантированный copy elision): фабрика инстанцируется для некопируемого и неперемещаемого зонда Pinned<T>. NRVO так доказать нельзя, для нее - elides_at_runtime со счетчиками LifetimeProbe.
+     */
+    {
+        must_elide::Start();
+    }
+    /*
+     Sink-параметры: по значению + std::move, пара перегрузок const&/&& и шаблон с идеальной передачей. Замер копирований, перемещений и времени для lvalue и rvalue аргументов (vector, string).
+     */
+    {
+        sink_parameters::Start();
+    }
+    /*
+     Expression templates - операторы возвращают узлы дерева выражения, а все выражение вычисляется одним циклом при присваивании: без временных массивов. Сравнение с жадной реализацией по времени и трафику памяти.
+     */
+    {
+        expression_templates::Start();
+    }
+    /*
+     Аудит noexcept перемещения: для каждого зарегистрированного класса проекта - is_nothrow_move_constructible/assignable и как std::vector переносит элементы при росте (перемещение или копирование). Замер стоимости переноса.
+     */
+    {
+        noexcept_audit::Start();
+    }
+    /*
+     COW (copy-on-write) - копия разделяет содержимое и увеличивает счетчик ссылок, глубокое копирование откладывается до первой записи. Атомарный и однопоточный счетчик, сравнение с копированием по значению и shared_ptr<const T>.
+     */
+    {
+        cow::Start();
+    }
+    /*
+     generator<T> - ленивая последовательность на корутинах C++20: объекты фабрики отдаются по одному через co_yield без промежуточного std::vector. Вложенные генераторы с симметричной передачей управления, кадры корутин из списков свободных блоков.
+     */
+    {
+        coroutine_generator::Start();
+    }
+    /*
+     pmr-фабрики: варианты RVO/NRVO/NO_NRVO, которые принимают std::pmr::memory_resource* - временные объекты запроса берут память из одного региона (стековый буфер или арена). Сравнение числа выделений памяти и времени с аллокатором по умолчанию.
+     */
+    {
+        pmr_factory::Start();
+    }
+    /*
+     Стоимость вызова print иерархии Base/Derived пятью способами: virtual, final + virtual, CRTP, std::variant + std::visit, таблица указателей на функции - для мономорфного и 2/4/16-полиморфного места вызова с предсказуемым и случайным порядком типов.
+     */
+    {
+        dispatch::Start();
+    }
+    /*
+     poly_value<Base, N> - полиморфный объект с семантикой значения: наследник до N байт хранится внутри (small buffer), больше - в куче; копирование/перемещение/разрушение через сгенерированную таблицу функций. Сравнение с vector<unique_ptr<Base>>.
+     */
+    {
+        poly_value::Start();
+    }
+    /*
+     poly_collection<Base> - полиморфная коллекция: объекты хранятся по сегментам своих типов, поэтому обход не перемешивает виртуальные вызовы, а восстановление типа (restitution) делает их прямыми. Сравнение с vector<unique_ptr<Base>>.
+     */
+    {
+        poly_collection::Start();
+    }
+    /*
+     Внешний полиморфизм - номер типа размером 1-4 байта хранится рядом с данными вместо vptr, а вызов идет через глобальную таблицу функций. Сравнение размера и времени обхода с виртуальными вызовами.
+     */
+    {
+        external_polymorphism::Start();
+    }
+    /*
+     Закрытая иерархия - список наследников объявлен один раз, вызов идет через switch по номеру типа вместо vptr, и компилятор встраивает реализацию.
+     */
+    {
+        closed_hierarchy::Start();
+    }
+    /*
+     Инструментирование NVI - невиртуальная точка входа считает вызовы и выборочно замеряет время по динамическому типу. Без флага NVI_INSTRUMENTATION проверка ничего не стоит.
+     */
+    {
+        nvi_instrumentation::Start();
+    }
+    /*
+     Встроенный кэш места вызова (inline cache) запоминает последний тип объекта и вызывает известное переопределение напрямую, а при другом типе делает обычный виртуальный вызов.
+     */
+    {
+        inline_cache::Start();
+    }
+    /*
+     Пулы объектов - у каждого типа иерархии свой пул, объект удаляется через пул без виртуального деструктора, а clear() уничтожает все объекты разом.
+     */
+    {
+        object_pool::Start();
+    }
+    /*
+     intrusive_ptr<T> - интрузивный подсчет ссылок: счетчик лежит в самом объекте, а указатель занимает одно слово. Политики счетчика relaxed/atomic/single thread, сравнение с shared_ptr для 1/2/4 потоков.
+     */
+    {
+        intrusive_ptr::Start();
+    }
+    /*
+     Эпохальное освобождение памяти (EBR) - читатели обходят объекты без счетчиков ссылок, а замененные объекты удаляются через виртуальный деструктор, когда их не видит ни один читатель. Сравнение с atomic<shared_ptr> и shared_mutex.
+     */
+    {
+        epoch_reclamation::Start();
+    }
+    /*
+     for_each_virtual - виртуальные вызовы идут пачками с программной предвыборкой (software prefetch) объектов и vtable на несколько элементов вперед. Сравнение с обычным циклом для указателей по порядку выделения и перемешанных.
+     */
+    {
+        prefetch_dispatch::Start();
+    }
 }